@@ -71,6 +71,7 @@ let package = Package(
                 "src/ImagePreprocessor.cpp",
                 "src/SorobanDetector.cpp",
                 "src/TensorConverter.cpp",
+                "src/TensorPool.cpp",
             ],
             publicHeadersPath: "include",
             cxxSettings: [
@@ -87,12 +88,34 @@ let package = Package(
             ]
         ),
 
+        // MARK: - AbacusVisionTestSupport (C++, テスト専用)
+
+        // C++ 実装を直接検証するための C API（製品には含めない）
+        .target(
+            name: "AbacusVisionTestSupport",
+            dependencies: [
+                "AbacusVision",
+            ],
+            path: "Sources/AbacusVisionTestSupport",
+            sources: [
+                "src/AbacusVisionTestSupport.cpp",
+            ],
+            publicHeadersPath: "include",
+            cxxSettings: [
+                .define("ABACUS_HAS_OPENCV", to: "1"),
+                .unsafeFlags(["-std=c++17"]),
+                .unsafeFlags(["-Wno-shorten-64-to-32"]),
+            ]
+        ),
+
         // MARK: - Tests
 
         .testTarget(
             name: "AbacusKitTests",
             dependencies: [
                 "AbacusKit",
+                "AbacusVision",
+                "AbacusVisionTestSupport",
             ],
             path: "Tests",
             exclude: ["README.md"]
@@ -208,7 +208,7 @@ public actor AbacusRecognizer {
         }
 
         let predictions = try await engine.predictBatch(
-            tensorData: visionResult.tensorData,
+            tensor: visionResult.tensor,
             cellCount: visionResult.cellCount
         )
         let inferenceTime = Date().timeIntervalSince(inferenceStart) * 1000
@@ -310,7 +310,7 @@ final class VisionProcessor: @unchecked Sendable {
         let frameCorners: [CGPoint]
         let laneCount: Int
         let laneBoundingBoxes: [CGRect]
-        let tensorData: [Float]
+        let tensor: VisionTensor?
         let cellCount: Int
         let detectionTimeMs: Double
     }
@@ -337,7 +337,7 @@ final class VisionProcessor: @unchecked Sendable {
             frameCorners: result.frameCorners,
             laneCount: result.laneCount,
             laneBoundingBoxes: result.laneBoundingBoxes,
-            tensorData: result.tensorData,
+            tensor: result.tensor,
             cellCount: result.cellCount,
             detectionTimeMs: result.detectionTimeMs
         )
@@ -83,7 +83,9 @@ final class VisionBridge: @unchecked Sendable {
     /// 5. Segments individual lanes (digit columns)
     /// 6. Converts lane images to tensors for inference
     ///
-    /// - Parameter pixelBuffer: A camera frame in BGRA or RGBA format.
+    /// - Parameter pixelBuffer: A camera frame in BGRA, RGBA, or 420 YpCbCr
+    ///   (NV12 / planar) format. YpCbCr frames are detected on the luma plane
+    ///   without a full-frame color conversion.
     /// - Returns: The extraction result containing frame, lanes, and tensor data.
     /// - Throws: ``AbacusError`` if processing fails.
     ///
@@ -92,17 +94,101 @@ final class VisionBridge: @unchecked Sendable {
     /// On iPhone 15 Pro, processing typically takes 8-12ms per frame,
     /// enabling 60+ FPS throughput.
     func process(pixelBuffer: CVPixelBuffer) throws -> VisionExtractionResult {
+        try run { instance, result in
+            ab_vision_process(instance, Unmanaged.passUnretained(pixelBuffer).toOpaque(), result)
+        }
+    }
+
+    /// Processes an image held in caller-owned memory.
+    ///
+    /// The planes are referenced without copying and only for the duration
+    /// of the call. Chroma planes of NV12 / I420 images can be passed
+    /// separately through `chromaData` and `chromaBytesPerRow`.
+    ///
+    /// - Parameter buffer: A description of the image planes.
+    /// - Returns: The extraction result containing frame, lanes, and tensor data.
+    /// - Throws: ``AbacusError`` if processing fails. Malformed buffers
+    ///   (for example a stride shorter than a row) are reported as
+    ///   ``AbacusError/preprocessingFailed(reason:code:)`` with the
+    ///   invalid-input code.
+    func process(buffer: ABImageBuffer) throws -> VisionExtractionResult {
+        try run { instance, result in
+            withUnsafePointer(to: buffer) { ab_vision_process_buffer(instance, $0, result) }
+        }
+    }
+
+    /// Directs subsequent tensors into caller-owned memory.
+    ///
+    /// Pass the input buffer of the inference runtime to have cells
+    /// converted straight into it. While a buffer is set, the returned
+    /// ``VisionTensor`` refers to that buffer and owns nothing; frames with
+    /// more cells than fit are reported as failures.
+    ///
+    /// - Parameters:
+    ///   - buffer: The destination, or `nil` to return to pooled allocation.
+    ///     The memory must stay valid until it is replaced or cleared.
+    ///   - capacity: The capacity of `buffer` in elements of the configured
+    ///     tensor type (cells × channels × height × width).
+    func setTensorOutput(_ buffer: UnsafeMutableRawPointer?, capacity: Int) {
+        guard let instance else { return }
+        ab_vision_set_tensor_output(instance, buffer, capacity)
+    }
+
+    // MARK: - Configuration
+
+    /// The preprocessing configuration of the native pipeline.
+    ///
+    /// Read the current values, change the fields you need, and pass the
+    /// result to ``setConfiguration(_:)``. `nil` if the bridge is not
+    /// initialized.
+    var configuration: ABVisionConfig? {
+        guard let instance else { return nil }
+
+        var config = ABVisionConfig()
+        guard ab_vision_get_config(instance, &config) == Int32(ABVisionErrorNone.rawValue) else {
+            return nil
+        }
+        return config
+    }
+
+    /// Replaces the preprocessing configuration of the native pipeline.
+    ///
+    /// The tensor options (element type, layout, channels and cell size)
+    /// apply to ``VisionTensor`` and to buffers set with
+    /// ``setTensorOutput(_:capacity:)``. ``AbacusInferenceEngine`` only
+    /// accepts the input of the bundled model (Float32, NCHW, three
+    /// channels); the other formats are for callers that hand the tensor to
+    /// their own runtime.
+    ///
+    /// - Parameter config: The new configuration.
+    /// - Throws: ``AbacusError/preprocessingFailed(reason:code:)`` with the
+    ///   invalid-input code if a value is out of range. The configuration is
+    ///   left unchanged in that case.
+    func setConfiguration(_ config: ABVisionConfig) throws {
+        guard let instance else {
+            throw AbacusError.preprocessingFailed(reason: "VisionBridge not initialized", code: -1)
+        }
+
+        let errorCode = withUnsafePointer(to: config) { ab_vision_set_config(instance, $0) }
+
+        guard errorCode == Int32(ABVisionErrorNone.rawValue) else {
+            throw mapError(code: errorCode)
+        }
+    }
+
+    // MARK: - Private
+
+    /// Runs one C API call and converts its result.
+    private func run(
+        _ body: (UnsafeMutableRawPointer, UnsafeMutablePointer<ABExtractionResult>) -> Int32
+    ) throws -> VisionExtractionResult {
         guard let instance else {
             throw AbacusError.preprocessingFailed(reason: "VisionBridge not initialized", code: -1)
         }
 
         var result = ABExtractionResult()
 
-        let errorCode = ab_vision_process(
-            instance,
-            Unmanaged.passUnretained(pixelBuffer).toOpaque(),
-            &result
-        )
+        let errorCode = body(instance, &result)
 
         defer {
             ab_vision_free_result(&result)
@@ -116,11 +202,9 @@ final class VisionBridge: @unchecked Sendable {
             throw AbacusError.frameNotDetected
         }
 
-        return convertResult(result)
+        return convertResult(&result)
     }
 
-    // MARK: - Private
-
     /// Maps C error codes to AbacusError cases.
     private func mapError(code: Int32) -> AbacusError {
         let errorType = ABVisionError(rawValue: UInt32(code))
@@ -146,7 +230,10 @@ final class VisionBridge: @unchecked Sendable {
     }
 
     /// Converts C structures to Swift types.
-    private func convertResult(_ result: ABExtractionResult) -> VisionExtractionResult {
+    ///
+    /// Ownership of a pooled tensor moves to the returned ``VisionTensor``,
+    /// so freeing `result` afterwards leaves the tensor alive.
+    private func convertResult(_ result: inout ABExtractionResult) -> VisionExtractionResult {
         // Convert frame information
         let frame = result.frame
         let frameRect = CGRect(
@@ -189,15 +276,8 @@ final class VisionBridge: @unchecked Sendable {
             }
         }
 
-        // Convert tensor data
-        var tensorData: [Float] = []
-        if let data = result.tensorData, result.tensorBatchSize > 0 {
-            let count = Int(result.tensorBatchSize) *
-                Int(result.tensorChannels) *
-                Int(result.tensorHeight) *
-                Int(result.tensorWidth)
-            tensorData = Array(UnsafeBufferPointer(start: data, count: count))
-        }
+        // Hand the tensor over without copying it
+        let tensor = VisionTensor(taking: &result)
 
         return VisionExtractionResult(
             frameDetected: frame.detected,
@@ -205,7 +285,7 @@ final class VisionBridge: @unchecked Sendable {
             frameCorners: frameCorners,
             laneCount: Int(result.frame.laneCount),
             laneBoundingBoxes: laneBoundingBoxes,
-            tensorData: tensorData,
+            tensor: tensor,
             cellCount: Int(result.totalCells),
             detectionTimeMs: result.preprocessingTimeMs
         )
@@ -238,11 +318,13 @@ struct VisionExtractionResult: Sendable {
     /// Bounding boxes for each detected lane in image coordinates.
     let laneBoundingBoxes: [CGRect]
 
-    /// Preprocessed tensor data ready for neural network inference.
+    /// Preprocessed tensor ready for neural network inference.
     ///
-    /// The data is in NCHW format (batch, channels, height, width) and
-    /// has been normalized according to the model's requirements.
-    let tensorData: [Float]
+    /// A view of the converted cells without an intermediate copy. With the
+    /// default configuration the data is Float32 in NCHW format (batch,
+    /// channels, height, width), normalized for the model. `nil` when no
+    /// cells were extracted.
+    let tensor: VisionTensor?
 
     /// The total number of cells (beads) to classify.
     ///
@@ -252,3 +334,128 @@ struct VisionExtractionResult: Sendable {
     /// The time spent in detection processing in milliseconds.
     let detectionTimeMs: Double
 }
+
+// MARK: - VisionTensor
+
+/// A read-only view of the batch tensor produced by the vision pipeline.
+///
+/// The elements are not copied into Swift storage. A tensor allocated by the
+/// native pool is returned to the pool when the last reference goes away;
+/// a tensor written into a buffer set with
+/// ``VisionBridge/setTensorOutput(_:capacity:)`` only refers to that buffer
+/// and is overwritten by the next processed frame.
+final class VisionTensor: @unchecked Sendable {
+    /// The element type of the tensor.
+    enum ElementType: Sendable {
+        /// Normalized 32-bit floats.
+        case float32
+        /// Normalized IEEE 754 half-precision floats.
+        case float16
+        /// Unnormalized 8-bit values.
+        case uint8
+    }
+
+    /// The memory layout of the tensor.
+    enum Layout: Sendable {
+        /// Batch, channels, height, width.
+        case nchw
+        /// Batch, height, width, channels.
+        case nhwc
+    }
+
+    /// Pointer to the first element.
+    let data: UnsafeRawPointer
+
+    /// The element type.
+    let elementType: ElementType
+
+    /// The memory layout.
+    let layout: Layout
+
+    /// The number of cells in the batch.
+    let batchSize: Int
+
+    /// The number of channels per cell.
+    let channels: Int
+
+    /// The height of each cell in pixels.
+    let height: Int
+
+    /// The width of each cell in pixels.
+    let width: Int
+
+    /// Pool memory released on deinitialization, if the tensor owns its data.
+    private let pooled: UnsafeMutableRawPointer?
+
+    /// The total number of elements.
+    var count: Int {
+        batchSize * channels * height * width
+    }
+
+    /// Creates a view of memory owned by the caller.
+    init(
+        data: UnsafeRawPointer,
+        elementType: ElementType,
+        layout: Layout,
+        batchSize: Int,
+        channels: Int,
+        height: Int,
+        width: Int
+    ) {
+        self.data = data
+        self.elementType = elementType
+        self.layout = layout
+        self.batchSize = batchSize
+        self.channels = channels
+        self.height = height
+        self.width = width
+        pooled = nil
+    }
+
+    /// Takes the tensor out of a C result, leaving the result without one.
+    ///
+    /// Returns `nil` if the result holds no tensor.
+    init?(taking result: inout ABExtractionResult) {
+        guard let tensorData = result.tensorData, result.tensorBatchSize > 0 else {
+            return nil
+        }
+
+        data = UnsafeRawPointer(tensorData)
+        switch result.tensorDataType {
+        case ABTensorDataTypeFloat16:
+            elementType = .float16
+        case ABTensorDataTypeUInt8:
+            elementType = .uint8
+        default:
+            elementType = .float32
+        }
+        layout = result.tensorLayout == ABTensorLayoutNHWC ? .nhwc : .nchw
+        batchSize = Int(result.tensorBatchSize)
+        channels = Int(result.tensorChannels)
+        height = Int(result.tensorHeight)
+        width = Int(result.tensorWidth)
+        pooled = result.tensorOwned ? tensorData : nil
+
+        result.tensorData = nil
+        result.tensorOwned = false
+    }
+
+    deinit {
+        guard let pooled else { return }
+
+        // ab_vision_free_result returns the tensor to the pool
+        var release = ABExtractionResult()
+        release.tensorData = pooled
+        release.tensorOwned = true
+        ab_vision_free_result(&release)
+    }
+
+    /// Calls `body` with the elements as 32-bit floats.
+    ///
+    /// - Returns: The result of `body`, or `nil` if the tensor is not Float32.
+    func withUnsafeFloats<R>(_ body: (UnsafeBufferPointer<Float>) throws -> R) rethrows -> R? {
+        guard elementType == .float32 else { return nil }
+        let floats = data.assumingMemoryBound(to: Float.self)
+        return try body(UnsafeBufferPointer(start: floats, count: count))
+    }
+}
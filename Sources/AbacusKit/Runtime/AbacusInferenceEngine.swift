@@ -191,20 +191,59 @@ public actor AbacusInferenceEngine {
         }
 
         // Validate input size
-        let expectedSize = cellCount * cellChannels * cellHeight * cellWidth
-        guard tensorData.count >= expectedSize else {
-            throw AbacusError.invalidInput(
-                reason: "Tensor data size mismatch: expected \(expectedSize), got \(tensorData.count)"
-            )
-        }
+        try validateTensorSize(tensorData.count, cellCount: cellCount)
 
         // Placeholder: Return dummy predictions
         // In production, this would call ExecuTorch inference
         return createDummyPredictions(count: cellCount)
     }
 
+    /// Predicts bead states from the tensor produced by the vision pipeline.
+    ///
+    /// The tensor is read in place; no intermediate `[Float]` is built, so it
+    /// must already be in the input format of the bundled model: Float32,
+    /// NCHW, three channels. Float16, UInt8, NHWC and single-channel tensors
+    /// that the vision pipeline can be configured to produce are meant for
+    /// callers that pass the tensor to their own runtime, and are rejected
+    /// here rather than converted.
+    ///
+    /// - Parameters:
+    ///   - tensor: The batch tensor, or `nil` if no cells were extracted.
+    ///   - cellCount: The number of cells in the tensor.
+    /// - Returns: An array of predictions, one per cell.
+    /// - Throws: ``AbacusError/modelNotLoaded`` if no model is loaded,
+    ///   or ``AbacusError/invalidInput(reason:)`` if the tensor is not in
+    ///   the model input format or its size is wrong.
+    func predictBatch(
+        tensor: VisionTensor?,
+        cellCount: Int
+    ) async throws -> [CellPrediction] {
+        guard modelLoaded else {
+            throw AbacusError.modelNotLoaded
+        }
+
+        if let tensor, tensor.elementType != .float32 || tensor.layout != .nchw || tensor.channels != cellChannels {
+            throw AbacusError.invalidInput(reason: "Tensor must be Float32 NCHW with \(cellChannels) channels")
+        }
+        try validateTensorSize(tensor?.count ?? 0, cellCount: cellCount)
+
+        // Placeholder: Return dummy predictions
+        // In production, this would bind tensor.data as the ExecuTorch input
+        return createDummyPredictions(count: cellCount)
+    }
+
     // MARK: - Private
 
+    /// Checks that a tensor holds at least `cellCount` cells.
+    private func validateTensorSize(_ count: Int, cellCount: Int) throws {
+        let expectedSize = cellCount * cellChannels * cellHeight * cellWidth
+        guard count >= expectedSize else {
+            throw AbacusError.invalidInput(
+                reason: "Tensor data size mismatch: expected \(expectedSize), got \(count)"
+            )
+        }
+    }
+
     /// Creates placeholder predictions when ExecuTorch is not available.
     private func createDummyPredictions(count: Int) -> [CellPrediction] {
         (0..<count).map { _ in
@@ -35,11 +35,27 @@ public:
     /// 検出パラメータを更新
     void setDetectionParams(const SorobanDetector::DetectionParams& params);
     
+    /// セル変換の実行器を設定（アプリ側のスレッドプールに委ねる場合）
+    /// 空の実行器を渡すと OpenCV の並列バックエンドに戻る。
+    void setConversionExecutor(TensorConverter::Executor executor);
+    
+    /// テンソルの出力先を設定（推論ランタイムの入力バッファへ直接書き込む）
+    /// 設定中は result.tensor がこのバッファを参照し、所有しない。
+    /// セル数に対して容量が足りないフレームは失敗として返す。
+    /// @param buffer 出力先（nullptr で内部確保に戻す）
+    /// @param capacity buffer の要素数（要素型は config の tensorDataType）
+    void setTensorOutput(void* buffer, size_t capacity);
+    
     /// CVPixelBuffer から完全な抽出を実行
     /// @param pixelBuffer CVPixelBufferRef
     /// @return 抽出結果
     ExtractionResult processPixelBuffer(const void* pixelBuffer);
     
+    /// 呼び出し側メモリから完全な抽出を実行（プラットフォーム非依存）
+    /// @param buffer 入力バッファ（処理中のみ参照される）
+    /// @return 抽出結果
+    ExtractionResult processBuffer(const ImageBuffer& buffer);
+    
     /// cv::Mat から完全な抽出を実行
     /// @param image 入力画像 (BGR)
     /// @return 抽出結果
@@ -57,10 +73,50 @@ private:
     std::unique_ptr<SorobanDetector> detector_;
     std::unique_ptr<TensorConverter> converter_;
     
-    FrameDetectionResult lastFrame_;
+    PreprocessWorkspace workspace_;
+    FrameDetectionResult lastFrame_{};
+    
+    // フレーム追跡の状態
+    int framesSinceKeyframe_ = 0;
+    int trackedWidth_ = 0;
+    int trackedHeight_ = 0;
+    
+    // 直接サンプリングしたセル画像（フレーム間で再利用）
+    std::vector<cv::Mat> cells_;
+    
+    // 正規化フレーム上のセル ROI（変換後は空にし、容量のみ再利用）
+    std::vector<cv::Mat> cellViews_;
+    
+    // 1 チャンネル出力用の CLAHE 補正済み正規化フレーム
+    cv::Mat enhancedFrame_;
+    
+    // 呼び出し側のテンソル出力先
+    void* tensorOutput_ = nullptr;
+    size_t tensorOutputCapacity_ = 0;
     
     /// 内部処理
     ExtractionResult processInternal(const cv::Mat& image);
+    
+    /// 内部処理（検出は縮小レベル、セルは元解像度から取得）
+    ExtractionResult processInternal(const SourceFrame& source);
+    
+    /// 入力バッファをラップして処理する
+    ExtractionResult processBufferInternal(const ImageBuffer& buffer);
+    
+    /// 検出レベル上で前回のフレームを追跡（失敗時は detected = false）
+    FrameDetectionResult trackLastFrame(const SourceFrame& source, const cv::Mat& level);
+    
+    /// 検出レベルでレーンを解析し、セルを元画像から直接サンプリングして抽出
+    void extractDirect(const SourceFrame& source, const cv::Mat& level, ExtractionResult& result);
+    
+    /// 輝度のみの正規化フレームを CLAHE で補正し、1 チャンネルのセルを抽出
+    void extractLuminance(const SourceFrame& source, ExtractionResult& result);
+    
+    /// 正規化済みフレームからレーン・セル・テンソルを抽出
+    void extractFromWarped(const cv::Mat& warped, ExtractionResult& result);
+    
+    /// セルをテンソルに変換（出力先が設定されていればそこへ書き込む）
+    VisionError convertCells(const std::vector<cv::Mat>& cells, BatchTensor& tensor);
 };
 
 // ============================================================
@@ -86,9 +142,23 @@ int32_t abacus_vision_process(
     ExtractionResult* result
 );
 
+/// 呼び出し側メモリを処理
+/// @param instance AbacusVision インスタンス
+/// @param buffer 入力バッファ
+/// @param result 結果を格納する構造体
+/// @return エラーコード
+int32_t abacus_vision_process_buffer(
+    void* instance,
+    const ImageBuffer* buffer,
+    ExtractionResult* result
+);
+
 /// テンソルメモリを解放
 void abacus_vision_free_result(ExtractionResult* result);
 
+/// テンソルの出力先を設定（nullptr で内部確保に戻す）
+void abacus_vision_set_tensor_output(void* instance, void* buffer, size_t capacity);
+
 /// 設定を更新
 void abacus_vision_set_config(void* instance, const PreprocessingConfig* config);
 
@@ -4,6 +4,7 @@
 #ifndef ABACUS_VISION_BRIDGE_H
 #define ABACUS_VISION_BRIDGE_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -54,6 +55,19 @@ typedef struct {
     float confidence;
 } ABLaneInfo;
 
+/// テンソルの要素型
+typedef enum {
+    ABTensorDataTypeFloat32 = 0,    // 正規化済み float
+    ABTensorDataTypeFloat16 = 1,    // 正規化済み half (IEEE 754 binary16)
+    ABTensorDataTypeUInt8 = 2       // 正規化なしの 8 ビット値
+} ABTensorDataType;
+
+/// テンソルの配置
+typedef enum {
+    ABTensorLayoutNCHW = 0,
+    ABTensorLayoutNHWC = 1
+} ABTensorLayout;
+
 /// 抽出結果
 typedef struct {
     bool success;
@@ -63,8 +77,12 @@ typedef struct {
     ABLaneInfo* lanes;
     int32_t laneCount;
     
-    // テンソルデータ（N × C × H × W, CHW format）
-    float* tensorData;
+    // テンソルデータ（配置は tensorLayout、要素型は tensorDataType）
+    // tensorOwned が false なら ab_vision_set_tensor_output で渡したバッファを指す
+    void* tensorData;
+    ABTensorDataType tensorDataType;
+    ABTensorLayout tensorLayout;
+    bool tensorOwned;
     int32_t tensorBatchSize;
     int32_t tensorChannels;
     int32_t tensorHeight;
@@ -77,6 +95,76 @@ typedef struct {
     double preprocessingTimeMs;
 } ABExtractionResult;
 
+/// 入力ピクセルフォーマット
+typedef enum {
+    ABPixelFormatBGRA = 0,
+    ABPixelFormatRGBA = 1,
+    ABPixelFormatBGR = 2,
+    ABPixelFormatRGB = 3,
+    ABPixelFormatGray = 4,
+    ABPixelFormatNV12 = 5,
+    ABPixelFormatI420 = 6
+} ABPixelFormat;
+
+/// 呼び出し側メモリの画像記述（プレーンはコピーされない）
+typedef struct {
+    const void* data;               // 先頭ピクセル（YUV では Y プレーン）へのポインタ
+    int32_t width;
+    int32_t height;
+    size_t bytesPerRow;             // 行ストライド（0 なら詰めて配置）
+    ABPixelFormat format;
+    
+    // 色差プレーン（NV12: [0]=UV, I420: [0]=U, [1]=V）
+    // NULL の場合は直前のプレーンの直後に連続配置されているものとする
+    const void* chromaData[2];
+    size_t chromaBytesPerRow[2];    // 0 なら輝度ストライドから算出
+} ABImageBuffer;
+
+/// 適応的二値化の方式（abacus::AdaptiveThresholdMethod と同じ値）
+typedef enum {
+    ABAdaptiveThresholdGaussian = 0,
+    ABAdaptiveThresholdMean = 1,
+    ABAdaptiveThresholdIntegral = 2
+} ABAdaptiveThresholdMethod;
+
+/// 前処理設定（abacus::PreprocessingConfig のうち C API から変更できる項目）
+/// ab_vision_get_config で現在値を取得し、必要な項目だけ書き換えて ab_vision_set_config に渡す。
+typedef struct {
+    // リサイズ
+    int32_t targetLongEdge;         // 前処理解像度の上限
+    int32_t detectionLongEdge;      // フレーム検出を行う縮小レベル（0 なら targetLongEdge）
+    
+    // 色補正・ノイズ低減
+    bool enableWhiteBalance;
+    bool enableCLAHE;
+    double claheClipLimit;
+    int32_t claheTileSize;
+    bool enableGaussianBlur;
+    
+    // 二値化
+    ABAdaptiveThresholdMethod adaptiveMethod;
+    int32_t adaptiveBlockSize;
+    double adaptiveC;
+    int32_t adaptiveThreads;        // Integral の並列数（0: 自動, 1: 単一スレッド）
+    
+    // テンソル正規化（R, G, B の順）
+    float mean[3];
+    float std[3];
+    float meanGray;                 // 1 チャンネル出力用
+    float stdGray;
+    
+    // 出力
+    int32_t cellOutputSize;
+    ABTensorDataType tensorDataType;
+    ABTensorLayout tensorLayout;
+    int32_t tensorChannels;         // 3 または 1（CLAHE 補正後の輝度のみ）
+    int32_t conversionThreads;      // セル変換の並列数（0: 自動, 1: 単一スレッド）
+    int32_t parallelMinCells;       // これ未満のセル数は単一スレッドで変換
+    
+    // セル抽出
+    bool enableDirectCellWarp;      // 正規化フレームを作らずセルを元画像から直接サンプリング
+} ABVisionConfig;
+
 /// エラーコード
 typedef enum {
     ABVisionErrorNone = 0,
@@ -111,7 +199,44 @@ int32_t ab_vision_process(
     ABExtractionResult* result
 );
 
+/// 呼び出し側メモリの画像を処理（CoreVideo 非依存）
+/// バッファはコピーされず、この呼び出しの間だけ参照される。
+/// NV12 / I420 の色差プレーンは chromaData で個別に渡せる（CVPixelBuffer の各プレーンなど）。
+/// @param instance AbacusVision インスタンス
+/// @param buffer 入力画像の記述
+/// @param result 結果を格納する構造体へのポインタ
+/// @return エラーコード
+int32_t ab_vision_process_buffer(
+    void* instance,
+    const ABImageBuffer* buffer,
+    ABExtractionResult* result
+);
+
+/// テンソルの出力先を設定
+/// 以降の処理結果は推論ランタイムの入力バッファなどに直接書き込まれ、コピーされない。
+/// 必要な要素数は セル数 × tensorChannels × cellOutputSize × cellOutputSize
+/// （ABVisionConfig の設定値、要素型は tensorDataType）。不足するフレームは失敗として返す。
+/// @param instance AbacusVision インスタンス
+/// @param buffer 出力先（NULL で内部確保に戻す）。設定中は呼び出し側が保持すること
+/// @param capacity buffer の要素数（要素型は設定中のテンソル要素型）
+void ab_vision_set_tensor_output(void* instance, void* buffer, size_t capacity);
+
+/// 現在の前処理設定を取得
+/// @param instance AbacusVision インスタンス
+/// @param config 設定を格納する構造体へのポインタ
+/// @return エラーコード
+int32_t ab_vision_get_config(void* instance, ABVisionConfig* config);
+
+/// 前処理設定を変更
+/// 範囲外の値を含む場合は何も変更せず ABVisionErrorInvalidInput を返す。
+/// テンソルの要素型・配置・チャンネル数を変えると ab_vision_set_tensor_output の capacity の単位も変わる。
+/// @param instance AbacusVision インスタンス
+/// @param config 新しい設定
+/// @return エラーコード
+int32_t ab_vision_set_config(void* instance, const ABVisionConfig* config);
+
 /// 結果のメモリを解放
+/// テンソル領域は内部のプールに返却され、次のフレームで再利用される。
 /// @param result 解放する結果構造体へのポインタ
 void ab_vision_free_result(ABExtractionResult* result);
 
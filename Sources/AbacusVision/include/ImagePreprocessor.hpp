@@ -69,6 +69,41 @@ namespace cv {
 
 namespace abacus {
 
+/// 前処理の中間バッファ
+///
+/// AbacusVision が所有し、フレーム間で使い回す。解像度が変わらない限り
+/// 各段の出力は既存の領域に書き込まれ、ヒープ確保は発生しない。
+struct PreprocessWorkspace {
+    cv::Mat resized;
+    cv::Mat balanced;
+    cv::Mat blurred;
+    cv::Mat filtered;
+    cv::Mat gray;
+    cv::Mat enhanced;
+    cv::Mat binarized;
+    cv::Mat morphScratch;
+    cv::Mat binary;
+    cv::Mat edges;
+};
+
+/// 取り込み済みの入力フレーム
+///
+/// 元解像度のまま呼び出し側メモリを参照する（コピーしない）。
+/// 検出は縮小した検出レベルで行い、セルはこのフレームから切り出す。
+struct SourceFrame {
+    cv::Mat image;              // パックド形式の画像（YUV / Gray では空）
+    int toBGR = -1;             // image → BGR の cvtColor コード（-1: BGR のまま）
+    cv::Mat luma;               // Y プレーン（YUV / Gray のみ）
+    cv::Mat chroma;             // NV12: UV インターリーブ、I420: U プレーン（半解像度）
+    cv::Mat chromaV;            // I420 の V プレーン（NV12 / Gray では空）
+    
+    bool isLuma() const { return !luma.empty(); }
+    bool isPlanarChroma() const { return !chromaV.empty(); }
+    bool empty() const { return image.empty() && luma.empty(); }
+    int width() const { return isLuma() ? luma.cols : image.cols; }
+    int height() const { return isLuma() ? luma.rows : image.rows; }
+};
+
 /// 画像前処理クラス
 /// 
 /// OpenCV を使用して画像の前処理を行う。
@@ -92,32 +127,89 @@ public:
     /// @return エラーコード
     VisionError convertFromPixelBuffer(const void* pixelBuffer, cv::Mat& output);
     
-    /// リサイズ（アスペクト比維持）
+    /// CVPixelBuffer をロックしてプレーン情報を取得
+    /// 成功した場合は unlockPixelBuffer を呼ぶまで buffer のポインタが有効
+    /// @param pixelBuffer CVPixelBufferRef
+    /// @param buffer 出力バッファ記述
+    /// @return エラーコード
+    VisionError lockPixelBuffer(const void* pixelBuffer, ImageBuffer& buffer);
+    
+    /// lockPixelBuffer でロックした CVPixelBuffer を解放
+    void unlockPixelBuffer(const void* pixelBuffer);
+    
+    /// 呼び出し側メモリから cv::Mat に変換（プラットフォーム非依存）
+    /// targetLongEdge への縮小と BGR 変換を 1 パスで内部作業バッファに書き込む。
+    /// 縮小不要な BGR 入力はコピーせずにラップする（出力はバッファの寿命に従う）。
+    /// @param buffer 入力バッファ
+    /// @param output 出力 Mat (BGR, 次回呼び出しまで有効)
+    /// @return エラーコード
+    VisionError convertFromBuffer(const ImageBuffer& buffer, cv::Mat& output);
+    
+    /// 呼び出し側メモリを元解像度のままラップする（I420 の U / V も別々のまま参照する）
+    /// @param buffer 入力バッファ
+    /// @param source 出力フレーム（buffer の寿命に従う）
+    /// @return エラーコード
+    VisionError wrapBuffer(const ImageBuffer& buffer, SourceFrame& source);
+    
+    /// 検出用の縮小画像を作成
+    /// 長辺を detectionLongEdge（0 なら targetLongEdge）に縮小し、
+    /// パックド形式は BGR に、YUV / Gray は Y のみにする。
+    /// @param source 入力フレーム
+    /// @param level 出力画像（次回呼び出しまで有効）
+    /// @return エラーコード
+    VisionError makeDetectionLevel(const SourceFrame& source, cv::Mat& level);
+    
+    // 各処理段は 2 通りの形式を持つ。
+    // - 戻り値版: 新しい Mat を返す（段が無効なら入力のビュー）
+    // - バッファ版: buffer に書き込んでその参照を返す（段が無効なら input の参照）
+    //   buffer はフレーム間で再利用され、同サイズなら再確保されない
+    
+    /// リサイズ（アスペクト比維持、縮小不要ならコピーしない）
     cv::Mat resize(const cv::Mat& input);
+    const cv::Mat& resize(const cv::Mat& input, cv::Mat& buffer);
     
     /// グレースケール変換
     cv::Mat toGrayscale(const cv::Mat& input);
+    const cv::Mat& toGrayscale(const cv::Mat& input, cv::Mat& buffer);
     
     /// ホワイトバランス補正
+    /// チャンネル別ゲインを 256 段の LUT にまとめ、インターリーブ BGR に 1 パスで適用する。
+    /// buffer に input 自身を渡すとその場で補正する。
     cv::Mat applyWhiteBalance(const cv::Mat& input);
+    const cv::Mat& applyWhiteBalance(const cv::Mat& input, cv::Mat& buffer);
+    
+    /// 複数画像に共通のホワイトバランス補正（平均は全画像の合算から推定し、その場で補正）
+    void applyWhiteBalance(std::vector<cv::Mat>& images);
     
     /// CLAHE（局所コントラスト強調）
     cv::Mat applyCLAHE(const cv::Mat& gray);
+    const cv::Mat& applyCLAHE(const cv::Mat& gray, cv::Mat& buffer);
+    
+    /// 元画像の一部を引き伸ばした画像（正規化フレームなど）への CLAHE
+    /// タイル数を元画像に占める割合で減らし、タイルの大きさを元画像全体への CLAHE と揃える。
+    /// @param coverageX gray が元画像の幅に占める割合 (0〜1]
+    /// @param coverageY gray が元画像の高さに占める割合 (0〜1]
+    const cv::Mat& applyCLAHE(const cv::Mat& gray, double coverageX, double coverageY, cv::Mat& buffer);
     
     /// ガウシアンブラー
     cv::Mat applyGaussianBlur(const cv::Mat& input);
+    const cv::Mat& applyGaussianBlur(const cv::Mat& input, cv::Mat& buffer);
     
     /// バイラテラルフィルタ（エッジ保持ノイズ低減）
     cv::Mat applyBilateralFilter(const cv::Mat& input);
+    const cv::Mat& applyBilateralFilter(const cv::Mat& input, cv::Mat& buffer);
     
-    /// 適応的二値化
+    /// 適応的二値化（方式は PreprocessingConfig::adaptiveMethod で選択）
     cv::Mat adaptiveThreshold(const cv::Mat& gray);
+    const cv::Mat& adaptiveThreshold(const cv::Mat& gray, cv::Mat& buffer);
     
     /// モルフォロジー演算（ノイズ除去）
     cv::Mat morphologyClean(const cv::Mat& binary);
+    const cv::Mat& morphologyClean(const cv::Mat& binary, cv::Mat& scratch, cv::Mat& buffer);
     
     /// エッジ検出 (Canny)
     cv::Mat detectEdges(const cv::Mat& gray);
+    const cv::Mat& detectEdges(const cv::Mat& gray, cv::Mat& buffer);
     
     /// 完全な前処理パイプライン
     /// @param input 入力画像 (BGR)
@@ -132,11 +224,113 @@ public:
         cv::Mat& edges
     );
     
+    /// 完全な前処理パイプライン（作業領域を再利用）
+    /// 出力は ws 内のバッファ（または input）へのビューで、次回呼び出しまで有効。
+    /// @param input 入力画像 (BGR)
+    /// @param ws 作業領域
+    /// @param preprocessed 前処理済み画像
+    /// @param binary 二値化画像
+    /// @param edges エッジ画像
+    /// @return エラーコード
+    VisionError preprocess(
+        const cv::Mat& input,
+        PreprocessWorkspace& ws,
+        cv::Mat& preprocessed,
+        cv::Mat& binary,
+        cv::Mat& edges
+    );
+    
+    /// 輝度のみの前処理パイプライン（色変換なし）
+    /// @param luma 入力 Y プレーン
+    /// @param binary 二値化画像
+    /// @param edges エッジ画像
+    /// @return エラーコード
+    VisionError preprocessLuma(
+        const cv::Mat& luma,
+        cv::Mat& binary,
+        cv::Mat& edges
+    );
+    
+    /// 輝度のみの前処理パイプライン（作業領域を再利用）
+    VisionError preprocessLuma(
+        const cv::Mat& luma,
+        PreprocessWorkspace& ws,
+        cv::Mat& binary,
+        cv::Mat& edges
+    );
+    
 private:
     PreprocessingConfig config_;
     cv::Ptr<cv::CLAHE> clahe_;
+    cv::Ptr<cv::CLAHE> regionClahe_;    // 部分画像用（タイル数は呼び出しごとに設定）
+    cv::Mat morphKernel_;
+    cv::Mat whiteBalanceLUT_;   // 1×256 CV_8UC3
+    cv::Mat integral_;          // 積分画像 (CV_32S、大きな入力では CV_64F)
+    cv::Mat paddedGray_;        // 積分前に端を複製した入力
+    
+    // 取り込み用の作業バッファ（フレーム間で再利用）
+    cv::Mat ingestBuffer_;
+    cv::Mat ingestScratch_;
+    cv::Mat lumaBuffer_;
+    cv::Mat chromaPlanes_[2];   // I420 の U / V を縮小したもの
+    cv::Mat chromaScratch_;
     
     void initCLAHE();
+    
+    /// チャンネル平均を間引きグリッド上で推定
+    cv::Scalar estimateChannelMeans(const cv::Mat& bgr) const;
+    
+    /// チャンネル平均からホワイトバランス LUT を構築
+    void buildWhiteBalanceLUT(const cv::Scalar& means);
+    
+    /// 積分画像による箱平均二値化（cv::adaptiveThreshold の MEAN_C と同じ結果）
+    /// blockSize は 2 × 長辺 + 1 で頭打ちにする（それ以上の窓では MEAN_C と一致しない場合がある）
+    void integralThreshold(const cv::Mat& gray, int blockSize, cv::Mat& output);
+    
+    /// 縮小率を計算（縮小不要なら 1.0）
+    double downscaleFactor(int width, int height, int targetLongEdge) const;
+    
+    /// 縮小と色変換を作業バッファ上で行う
+    /// @param src 入力画像
+    /// @param code cvtColor のコード（-1 なら変換しない）
+    /// @param longEdge 縮小後の長辺
+    /// @param output 出力 Mat
+    void resizeAndConvert(const cv::Mat& src, int code, int longEdge, cv::Mat& output);
+    
+    /// Y / UV プレーンを 4:2:0 の関係を保って縮小（I420 は縮小後に UV へまとめる）
+    void resizePlanes(const SourceFrame& source, int longEdge, cv::Mat& luma, cv::Mat& chroma);
+};
+
+/// CVPixelBuffer のロックをスコープ終了時に解除する
+///
+/// 処理中に OpenCV の例外が送出されても、カメラのバッファがロックされたまま残らないようにする。
+class PixelBufferLock {
+public:
+    PixelBufferLock(ImagePreprocessor& preprocessor, const void* pixelBuffer)
+        : preprocessor_(preprocessor), pixelBuffer_(pixelBuffer) {
+        error_ = preprocessor_.lockPixelBuffer(pixelBuffer_, buffer_);
+    }
+    
+    ~PixelBufferLock() {
+        if (error_ == VisionError::None) {
+            preprocessor_.unlockPixelBuffer(pixelBuffer_);
+        }
+    }
+    
+    PixelBufferLock(const PixelBufferLock&) = delete;
+    PixelBufferLock& operator=(const PixelBufferLock&) = delete;
+    
+    /// ロックの結果（None 以外なら buffer は無効）
+    VisionError error() const { return error_; }
+    
+    /// ロック中のプレーン情報
+    const ImageBuffer& buffer() const { return buffer_; }
+    
+private:
+    ImagePreprocessor& preprocessor_;
+    const void* pixelBuffer_;
+    ImageBuffer buffer_;
+    VisionError error_;
 };
 
 } // namespace abacus
@@ -13,6 +13,9 @@ namespace abacus {
 /// 可変レーン数に対応。
 class SorobanDetector {
 public:
+    /// 1 レーンあたりのセル数（上珠1 + 下珠4）
+    static constexpr int kCellsPerLane = 5;
+    
     /// 検出パラメータ
     struct DetectionParams {
         // フレーム検出
@@ -25,6 +28,10 @@ public:
         int minLaneCount = 1;               // 最小レーン数
         int maxLaneCount = 27;              // 最大レーン数（通常のそろばん）
         double laneHeightRatio = 0.8;       // レーン高さの許容範囲
+        bool enablePitchEstimation = false; // 列射影の周期から珠棒の間隔を推定してレーン数を決める（モデルを検証するまで無効）
+        double pitchMinConfidence = 0.3;    // これ未満なら窓内最大によるピーク検出に戻す
+        bool enableRodCenteredLanes = false; // 周期推定が信頼できれば各レーンを珠棒の中心に合わせる（enablePitchEstimation が必要、モデルを検証するまで無効）
+        double laneCropRatio = 0.9;         // 珠棒中心のレーン幅（珠棒間隔に対する比、珠の幅を含む程度）
         
         // Hough変換
         double houghRho = 1.0;
@@ -35,6 +42,17 @@ public:
         
         // 輪郭近似
         double contourApproxEpsilon = 0.02;
+        int maxFrameContours = 32;          // 多角形近似まで進める輪郭数の上限（外接矩形の大きい順、0 で無制限）
+        
+        // フレーム追跡（キーフレーム間は前回の4隅を局所的に補正するだけにする）
+        bool enableTracking = true;
+        int trackingKeyframeInterval = 30;  // 全体検出をやり直すまでの最大フレーム数
+        int trackingSearchRadius = 6;       // コーナー補正の探索半径（検出レベルの px）
+        double trackingMinSupport = 0.6;    // 辺上のエッジ支持率の下限
+        int trackingEdgeThreshold = 20;     // エッジとみなす輝度差
+        
+        // 射影変換キャッシュ（4隅の移動がこの範囲内なら remap テーブルを再利用）
+        float warpCacheTolerance = 0.5f;    // 元解像度の px
         
         // セル分割
         int upperBeadRatio = 1;              // 上珠の相対高さ
@@ -42,6 +60,16 @@ public:
         int beadDividerRatio = 1;            // 中央仕切りの相対高さ
     };
     
+    /// 珠棒の周期推定結果
+    struct RodPitch {
+        bool valid = false;
+        double pitch = 0.0;         // 珠棒の間隔（px、小数精度）
+        double phase = 0.0;         // 珠棒の中心位置の周期内オフセット（px、0 ≤ phase < pitch）
+        double confidence = 0.0;    // 周期性の強さ (0.0〜1.0、正規化自己相関)
+        double firstRod = 0.0;      // 最も左の珠棒の中心位置（px）
+        int rodCount = 0;           // 珠棒の数（maxLaneCount 以下）
+    };
+    
     SorobanDetector();
     explicit SorobanDetector(const DetectionParams& params);
     ~SorobanDetector();
@@ -60,6 +88,17 @@ public:
         const cv::Mat& edges
     );
     
+    /// 前回の検出結果を局所探索で追跡
+    /// 各隅をサブピクセル補正し、4辺に沿ったエッジ支持率を信頼度とする。
+    /// 支持率が trackingMinSupport 未満なら detected = false を返す。
+    /// @param gray 検出レベルのグレースケール画像
+    /// @param previous 前回の検出結果（gray 座標系）
+    /// @return 追跡結果
+    FrameDetectionResult trackFrame(
+        const cv::Mat& gray,
+        const FrameDetectionResult& previous
+    );
+    
     /// 射影変換でフレームを正規化
     /// @param original オリジナル画像
     /// @param frame 検出されたフレーム
@@ -73,40 +112,214 @@ public:
         int outputHeight = 200
     );
     
+    /// 射影変換で YUV 平面からフレームを正規化
+    /// 輝度と色差を別々に変換し、出力サイズでのみ BGR に変換する。
+    /// @param luma Y プレーン
+    /// @param chroma UV インターリーブ（半解像度、空ならグレースケール扱い）
+    /// @param frame 検出されたフレーム（luma 座標系）
+    /// @param outputWidth 出力幅（偶数）
+    /// @param outputHeight 出力高さ（偶数）
+    /// @return 正規化された画像 (BGR)
+    cv::Mat warpFrame(
+        const cv::Mat& luma,
+        const cv::Mat& chroma,
+        const FrameDetectionResult& frame,
+        int outputWidth = 800,
+        int outputHeight = 200
+    );
+    
+    /// 射影変換で元解像度の入力フレームを正規化
+    /// @param source 入力フレーム
+    /// @param frame 検出されたフレーム（source 座標系）
+    /// @param outputWidth 出力幅
+    /// @param outputHeight 出力高さ
+    /// @return 正規化された画像 (BGR)
+    cv::Mat warpFrame(
+        const SourceFrame& source,
+        const FrameDetectionResult& frame,
+        int outputWidth = 800,
+        int outputHeight = 200
+    );
+    
+    /// 検出レベルからレーン解析用の正規化画像を作成
+    /// 元解像度の warpFrame とは別の変換テーブルをキャッシュする。
+    /// @param level 検出レベルの画像
+    /// @param frame 検出されたフレーム（level 座標系）
+    /// @param outputWidth 出力幅
+    /// @param outputHeight 出力高さ
+    /// @return 正規化された画像
+    cv::Mat warpLevelFrame(
+        const cv::Mat& level,
+        const FrameDetectionResult& frame,
+        int outputWidth = 800,
+        int outputHeight = 200
+    );
+    
+    /// 正規化フレーム上のセル矩形を元画像から直接サンプリング
+    /// 各セルの出力画素を射影変換で元画像に戻し、1 回の補間で cellSize × cellSize にする。
+    /// @param source 入力フレーム
+    /// @param frame 検出されたフレーム（source 座標系）
+    /// @param frameWidth 正規化フレームの幅（cellRects の座標系）
+    /// @param frameHeight 正規化フレームの高さ
+    /// @param cellRects セル矩形のリスト
+    /// @param cellSize 出力セルの一辺
+    /// @param cells 出力セル画像 (BGR)。既存の領域は再利用される
+    void warpCells(
+        const SourceFrame& source,
+        const FrameDetectionResult& frame,
+        int frameWidth,
+        int frameHeight,
+        const std::vector<cv::Rect>& cellRects,
+        int cellSize,
+        std::vector<cv::Mat>& cells
+    );
+    
     /// レーン数を自動検出
     /// @param warpedFrame 射影変換後の画像
     /// @return 検出されたレーン数
     int detectLaneCount(const cv::Mat& warpedFrame);
     
+    /// レーン数を自動検出し、境界候補の位置も返す
+    /// 縦方向エッジの列射影の周期から珠棒を求め、珠棒の中間を境界とする。
+    /// 周期性が弱い場合は窓内最大（非最大抑制）を O(幅) で求めて境界とする。
+    /// @param warpedFrame 射影変換後の画像
+    /// @param peaks 境界候補の列位置（昇順、warpedFrame の座標系）
+    /// @return 検出されたレーン数（peaks.size() - 1 を minLaneCount〜maxLaneCount に丸めたもの）
+    int detectLaneCount(const cv::Mat& warpedFrame, std::vector<int>& peaks);
+    
+    /// 珠棒の間隔と位置を推定
+    /// 縦方向エッジの列射影の自己相関を DFT で求め (O(n log n))、
+    /// 最も強い周期と、その周期成分の位相から珠棒の中心位置を求める。
+    /// @param warpedFrame 射影変換後の画像
+    /// @return 推定結果（レーン数の範囲に収まる周期がなければ valid = false）
+    RodPitch estimateRodPitch(const cv::Mat& warpedFrame);
+    
+    /// 縦方向エッジの列射影から珠棒の間隔と位置を推定
+    /// 周期は 幅 / (maxLaneCount × 2) 〜 幅 / minLaneCount の範囲で探す（枠の分だけ珠棒の並びは幅より狭い）。
+    /// 2 倍のラグにも相関の極大がない周期（珠棒の両縁の間隔など）は採用しない。
+    /// 珠棒の並びは周期の格子のうち射影の支えがある最長の連続区間とし、枠の部分は含めない。
+    /// @param projection 列射影
+    /// @return 推定結果（レーン数の範囲に収まる周期がなければ valid = false）
+    RodPitch estimateRodPitch(const std::vector<int>& projection) const;
+    
     /// レーンを分割
     /// @param warpedFrame 射影変換後の画像
     /// @param laneCount レーン数
     /// @return レーン情報のリスト
     std::vector<LaneInfo> extractLanes(const cv::Mat& warpedFrame, int laneCount);
     
+    /// 珠棒を中心にレーンを分割（幅は pitch × laneCropRatio、画像外は切り詰める）
+    /// @param warpedFrame 射影変換後の画像
+    /// @param rods 珠棒の周期推定結果
+    /// @return レーン情報のリスト（rods.rodCount 個）
+    std::vector<LaneInfo> extractLanes(const cv::Mat& warpedFrame, const RodPitch& rods);
+    
+    /// レーン数の検出と分割をまとめて行う（列射影は 1 回だけ計算する）
+    /// enableRodCenteredLanes かつ周期推定が信頼できれば珠棒中心、それ以外は等幅で分割する。
+    /// @param warpedFrame 射影変換後の画像
+    /// @return レーン情報のリスト
+    std::vector<LaneInfo> detectLanes(const cv::Mat& warpedFrame);
+    
     /// 単一レーンからセルを抽出
+    /// セルは lane の ROI で、画素はコピーしない（lane の元画像を参照し続ける）。
     /// @param lane レーン画像
     /// @param laneInfo レーン情報（更新される）
     /// @return 抽出されたセル画像（上珠1 + 下珠4 = 5枚）
     std::vector<cv::Mat> extractCells(const cv::Mat& lane, LaneInfo& laneInfo);
     
+    /// 単一レーンのセルを cells の末尾に追加（画素はコピーしない）
+    /// 全レーン分を 1 つのリストに集める場合は、呼び出し側で
+    /// レーン数 × kCellsPerLane を予約しておけば再確保が起きない。
+    /// @param lane レーン画像
+    /// @param laneInfo レーン情報（更新される）
+    /// @param cells 出力先（lane への ROI を kCellsPerLane 個追加）
+    void extractCells(const cv::Mat& lane, LaneInfo& laneInfo, std::vector<cv::Mat>& cells);
+    
+    /// レーン矩形内のセル矩形を計算（上珠1 + 下珠4 = 5個、lane と同じ座標系）
+    std::vector<cv::Rect> computeCellRects(const cv::Rect& lane) const;
+    
+    /// 半径 radius の窓で最大となる位置を O(n) で列挙（非最大抑制）
+    /// 単調減少の両端キューで窓内最大を保ち、窓の中心が最大なら採用する。
+    /// 同値が並ぶ場合は最も左の位置のみを残すので、採用した位置どうしは radius より離れる。
+    /// @param signal 入力系列
+    /// @param radius 窓の半径（窓幅は 2 × radius + 1、端の radius 個は対象外）
+    /// @param threshold これ以下の値は採用しない
+    /// @param peaks 出力（昇順）
+    static void findWindowPeaks(const std::vector<int>& signal, int radius, int threshold, std::vector<int>& peaks);
+    
+    /// 行帯 [rowBegin, rowEnd) の縦方向エッジの列射影を 1 回の行走査で計算
+    /// @param gray グレースケール画像 (CV_8UC1)
+    /// @param rowBegin 行帯の先頭（画像外は切り詰める）
+    /// @param rowEnd 行帯の終端
+    /// @param gradient 列ごとの水平 Sobel 絶対値（255 で飽和）の和
+    static void projectColumns(const cv::Mat& gray, int rowBegin, int rowEnd, std::vector<int>& gradient);
+    
 private:
+    /// 射影変換と固定小数点 remap テーブルのキャッシュ
+    struct WarpCache {
+        Quadrilateral corners{};
+        cv::Size sourceSize;
+        cv::Size outputSize;
+        cv::Mat map1;               // CV_16SC2 (整数座標)
+        cv::Mat map2;               // CV_16UC1 (補間係数)
+        bool valid = false;
+    };
+    
     DetectionParams params_;
+    WarpCache frameWarp_;
+    WarpCache chromaWarp_;
+    WarpCache levelWarp_;
+    
+    // セル単位の射影変換の作業領域
+    cv::Mat cellScratch_;
+    cv::Mat cellChromaScratch_;
+    cv::Mat cellChromaPlanes_[2];   // I420 の U / V（セルごとに変換してから UV にまとめる）
+    cv::Mat cellColorScratch_;  // 奇数サイズのセルを切り出す前の BGR
+    
+    // 輪郭抽出の作業領域
+    std::vector<std::vector<cv::Point>> contours_;
+    
+    /// キャッシュ済みテーブルで射影変換（4隅が許容範囲を超えて動いたら再計算）
+    cv::Mat warpWithCache(
+        const cv::Mat& original,
+        const Quadrilateral& corners,
+        int outputWidth,
+        int outputHeight,
+        WarpCache& cache
+    );
+    
+    /// フレーム候補（4頂点に近似した輪郭とその面積）
+    struct FrameCandidate {
+        std::vector<cv::Point> quad;
+        double area;
+    };
     
     /// 輪郭からそろばんフレーム候補を抽出
-    std::vector<std::vector<cv::Point>> findFrameCandidates(
+    /// 点数・外接矩形の面積と縦横比で先に絞り込み、残りのうち外接矩形の大きい
+    /// maxFrameContours 個だけを面積計算と多角形近似にかける。
+    std::vector<FrameCandidate> findFrameCandidates(
         const cv::Mat& binary,
         double imageArea
     );
     
+    /// 4辺に沿ったエッジ支持率を計算 (0.0〜1.0)
+    double measureEdgeSupport(const cv::Mat& gray, const Quadrilateral& quad) const;
+    
     /// 四角形の4隅を順序付け（左上、右上、右下、左下）
     Quadrilateral orderCorners(const std::vector<cv::Point>& contour);
     
-    /// 投影ヒストグラムでレーン境界を検出
-    std::vector<int> detectLaneBoundaries(const cv::Mat& gray);
+    /// 列射影からレーン数と境界候補を求める（detectLaneCount の本体）
+    /// @param rods 周期推定の結果（推定しなかった場合は valid = false）
+    int countLanes(const std::vector<int>& projection, std::vector<int>& peaks, RodPitch& rods) const;
+    
+    /// 周期の格子点ごとに珠棒の支えを評価し、firstRod と rodCount を決める
+    /// 支え = 格子点 ±pitch/4 の射影の平均 − 周期 1 つ分の最小値。中央値の半分以上が続く
+    /// 最長の区間を珠棒とし、maxLaneCount を超える分は支えの弱い端から除く。
+    void locateRods(const std::vector<int>& projection, RodPitch& rods) const;
+    
+    /// 縦方向エッジの列射影を計算（カラー画像はグレースケールにしてから射影する）
+    static void projectGradient(const cv::Mat& warpedFrame, std::vector<int>& projection);
     
-    /// Hough変換で垂直線を検出
-    std::vector<int> detectVerticalLines(const cv::Mat& edges);
 };
 
 } // namespace abacus
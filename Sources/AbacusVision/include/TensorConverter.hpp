@@ -3,6 +3,8 @@
 
 #include "VisionTypes.hpp"
 #include "ImagePreprocessor.hpp" // OpenCV stubs if needed
+#include "TensorPool.hpp"
+#include <functional>
 #include <vector>
 
 namespace abacus {
@@ -12,33 +14,98 @@ namespace abacus {
 /// OpenCV Mat を ExecuTorch 用のテンソル形式に変換する。
 class TensorConverter {
 public:
+    /// セル変換の実行器
+    /// count 個のセルを任意に分割し、各区間 [begin, end) について body を呼ぶ。
+    /// すべての body が終わるまで戻らないこと。
+    using Executor = std::function<void(
+        size_t count,
+        const std::function<void(size_t begin, size_t end)>& body
+    )>;
+    
     TensorConverter();
     explicit TensorConverter(const PreprocessingConfig& config);
     ~TensorConverter();
     
-    void setConfig(const PreprocessingConfig& config) { config_ = config; }
+    /// 設定を更新（平均・標準偏差が変わった場合は正規化 LUT を再構築）
+    void setConfig(const PreprocessingConfig& config);
+    
+    /// セル変換の実行器を設定（空なら OpenCV の並列バックエンドを使う）
+    void setExecutor(Executor executor) { executor_ = std::move(executor); }
     
     /// 単一セルをテンソルに変換
-    /// @param cell セル画像 (BGR)
+    /// @param cell セル画像 (BGR / Gray)
     /// @param tensor 出力テンソル
     /// @return エラーコード
     VisionError convertCell(const cv::Mat& cell, CellTensor& tensor);
     
-    /// 複数セルをバッチテンソルに変換
+    /// 複数セルをバッチテンソルに変換（要素型・配置は config に従う）
     /// @param cells セル画像のリスト
     /// @param batch 出力バッチテンソル
     /// @return エラーコード
     VisionError convertBatch(const std::vector<cv::Mat>& cells, BatchTensor& batch);
     
-    /// テンソルメモリを解放
+    /// 複数セルを呼び出し側のバッファへ直接変換
+    /// 要素型・配置は config の tensorDataType / tensorLayout に従う。
+    /// @param cells セル画像のリスト
+    /// @param destination 出力先（batch は所有せずに参照する）
+    /// @param capacity destination の要素数（不足時は MemoryAllocationFailed）
+    /// @param batch 出力バッチテンソル
+    /// @return エラーコード
+    VisionError convertBatch(
+        const std::vector<cv::Mat>& cells,
+        void* destination,
+        size_t capacity,
+        BatchTensor& batch
+    );
+    
+    /// cellCount 個のセルに必要な要素数
+    size_t requiredCapacity(size_t cellCount) const;
+    
+    /// テンソルメモリを解放（バッチは TensorPool に返却して次フレームで再利用）
     static void freeTensor(CellTensor& tensor);
     static void freeBatch(BatchTensor& batch);
     
+    /// float → IEEE 754 binary16（最近接偶数丸め、範囲外は ±inf、NaN は quiet NaN）
+    static uint16_t toHalf(float value);
+    
 private:
     PreprocessingConfig config_;
+    Executor executor_;
+    
+    // 正規化テーブル（出力平面 R, G, B、1 チャンネル出力用の輝度の順）
+    float normLUT_[4][256];
+    uint16_t halfLUT_[4][256];  // normLUT_ を half に丸めたもの
+    float normScale_[4];
+    float normBias_[4];
+    
+    /// 平均・標準偏差から正規化テーブルを構築
+    void buildNormalizationLUT();
+    
+    /// 出力のチャンネル数（tensorChannels が 1 なら輝度のみ、それ以外は RGB）
+    int outputChannels() const;
+    
+    /// セル画像 (BGR / Gray) を RGB 順（1 チャンネル時は輝度）の正規化テンソルに変換
+    /// リサイズ・チャンネル入れ替え・正規化・配置を 1 パスで行う。
+    /// @param cell セル画像（任意サイズ）
+    /// @param dataType 出力の要素型
+    /// @param layout 出力の配置（CHW / HWC）
+    /// @param output 出力先 (C × cellOutputSize × cellOutputSize)
+    /// @return エラーコード
+    VisionError convertToTensor(
+        const cv::Mat& cell,
+        TensorDataType dataType,
+        TensorLayout layout,
+        void* output
+    ) const;
     
-    /// 画像を正規化してテンソルに変換
-    void normalize(const cv::Mat& input, float* output);
+    /// 出力サイズの 1 行 (BGR / 輝度) を要素型・配置に応じて変換し、y 行目として書き込む
+    void writeRow(
+        const uint8_t* row,
+        int y,
+        TensorDataType dataType,
+        TensorLayout layout,
+        void* output
+    ) const;
 };
 
 } // namespace abacus
@@ -0,0 +1,82 @@
+#ifndef TENSOR_POOL_HPP
+#define TENSOR_POOL_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace abacus {
+
+/// テンソル用メモリプール
+///
+/// 要求サイズを容量クラス（2 のべき乗の間を 4 分割）に切り上げて確保し、
+/// 返却済みバッファを同じクラスの次の要求で再利用する。セル数が少し変わっても
+/// 同じバッファが使われる。未使用バッファは個数と合計バイト数の上限を超えると
+/// 古いものから解放する。バッファは 64 バイト境界に揃えて確保する。スレッドセーフ。
+class TensorPool {
+public:
+    static constexpr size_t kAlignment = 64;
+    
+    TensorPool();
+    ~TensorPool();
+    
+    TensorPool(const TensorPool&) = delete;
+    TensorPool& operator=(const TensorPool&) = delete;
+    
+    /// プロセス共通のプール（プロセス終了まで破棄されない）
+    static TensorPool& shared();
+    
+    /// bytes バイト以上のバッファを取得
+    /// @param bytes バイト数（容量クラスに切り上げて確保する）
+    /// @return バッファ（確保失敗時は nullptr）
+    void* acquire(size_t bytes);
+    
+    /// acquire で取得したバッファを返却
+    /// @param data 返却するバッファ
+    /// @return プールが確保したバッファなら true（それ以外は何もしない）
+    bool release(void* data);
+    
+    /// 保持している未使用バッファをすべて解放
+    void trim();
+    
+    /// 保持する未使用バッファの個数の上限（全容量クラスの合計）
+    void setMaxRetained(size_t count);
+    
+    /// 保持する未使用バッファの合計バイト数の上限
+    void setMaxRetainedBytes(size_t bytes);
+    
+    /// bytes を切り上げた容量クラス
+    static size_t sizeClass(size_t bytes);
+    
+    /// 大きなバッファをヒュージページで確保するか（対応プラットフォームのみ）
+    void setUseHugePages(bool enabled);
+    
+private:
+    /// 未使用バッファ
+    struct IdleBuffer {
+        void* data;
+        size_t capacity;
+    };
+    
+    std::mutex mutex_;
+    std::vector<IdleBuffer> available_;                 // 未使用バッファ（返却の古い順）
+    std::unordered_map<void*, size_t> capacities_;      // 確保済みバッファ → 容量
+    size_t retainedBytes_ = 0;                          // available_ の合計容量
+    size_t maxRetained_ = 4;
+    size_t maxRetainedBytes_ = 256 * 1024 * 1024;
+    bool useHugePages_ = false;
+    
+    /// 上限を超えた未使用バッファを古い順に解放（mutex_ を保持して呼ぶ）
+    void evictLocked();
+    
+    /// 整列済みメモリを確保
+    static void* allocate(size_t bytes, bool hugePages);
+    
+    /// allocate で確保したメモリを解放
+    static void deallocate(void* data);
+};
+
+} // namespace abacus
+
+#endif // TENSOR_POOL_HPP
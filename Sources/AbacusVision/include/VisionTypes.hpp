@@ -1,6 +1,7 @@
 #ifndef ABACUS_VISION_TYPES_HPP
 #define ABACUS_VISION_TYPES_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -34,6 +35,51 @@ struct Quadrilateral {
     Point bottomLeft;
 };
 
+/// 入力ピクセルフォーマット
+enum class PixelFormat : int32_t {
+    BGRA = 0,
+    RGBA = 1,
+    BGR = 2,
+    RGB = 3,
+    Gray = 4,
+    NV12 = 5,   // Y プレーン + UV インターリーブ（半解像度）
+    I420 = 6    // Y プレーン + U プレーン + V プレーン（半解像度）
+};
+
+/// 輝度プレーンを直接読めるフォーマットか
+inline bool isLumaFormat(PixelFormat format) {
+    return format == PixelFormat::NV12 || format == PixelFormat::I420 || format == PixelFormat::Gray;
+}
+
+/// 呼び出し側が所有する画像メモリ（コピーせずに参照する）
+struct ImageBuffer {
+    const void* data;           // 先頭ピクセル（YUV では Y プレーン）へのポインタ
+    int32_t width;
+    int32_t height;
+    size_t bytesPerRow;         // 行ストライド（0 なら詰めて配置）
+    PixelFormat format;
+    
+    // 色差プレーン（NV12: [0]=UV, I420: [0]=U, [1]=V）
+    // nullptr の場合は直前のプレーンの直後に連続配置されているものとする
+    const void* chromaData[2];
+    size_t chromaBytesPerRow[2]; // 0 なら輝度ストライドから算出
+    
+    ImageBuffer() : ImageBuffer(nullptr, 0, 0, 0, PixelFormat::BGRA) {}
+    ImageBuffer(const void* d, int32_t w, int32_t h, size_t stride, PixelFormat f)
+        : data(d), width(w), height(h), bytesPerRow(stride), format(f),
+          chromaData{nullptr, nullptr}, chromaBytesPerRow{0, 0} {}
+};
+
+/// 四角形の座標を拡大縮小
+inline Quadrilateral scaleQuadrilateral(const Quadrilateral& q, float sx, float sy) {
+    Quadrilateral result;
+    result.topLeft = Point(q.topLeft.x * sx, q.topLeft.y * sy);
+    result.topRight = Point(q.topRight.x * sx, q.topRight.y * sy);
+    result.bottomRight = Point(q.bottomRight.x * sx, q.bottomRight.y * sy);
+    result.bottomLeft = Point(q.bottomLeft.x * sx, q.bottomLeft.y * sy);
+    return result;
+}
+
 /// セル状態
 enum class CellState : int32_t {
     Upper = 0,   // 上位置（カウントしない）
@@ -67,9 +113,32 @@ struct FrameDetectionResult {
     int32_t laneCount;          // 検出されたレーン数
 };
 
+/// テンソルの要素型
+enum class TensorDataType : int32_t {
+    Float32 = 0,    // 正規化済み float
+    Float16 = 1,    // 正規化済み half (IEEE 754 binary16)
+    UInt8 = 2       // 正規化なしの 8 ビット値（正規化はモデル側で行う）
+};
+
+/// テンソルの配置
+enum class TensorLayout : int32_t {
+    NCHW = 0,       // 平面順（チャンネルごとに H × W）
+    NHWC = 1        // チャンネル末尾（画素ごとに RGB）
+};
+
+/// 要素型ごとのバイト数
+inline size_t tensorElementSize(TensorDataType type) {
+    switch (type) {
+        case TensorDataType::Float16: return 2;
+        case TensorDataType::UInt8: return 1;
+        case TensorDataType::Float32:
+        default: return 4;
+    }
+}
+
 /// 前処理済みテンソル（1セル分）
 struct CellTensor {
-    float* data;                // CHW format (3 × H × W)
+    float* data;                // CHW format (C × H × W)
     int32_t channels;
     int32_t height;
     int32_t width;
@@ -82,37 +151,63 @@ struct CellTensor {
 
 /// バッチテンソル（複数セル分）
 struct BatchTensor {
-    float* data;                // N × C × H × W
+    void* data;                 // N × C × H × W または N × H × W × C（要素型は dataType）
     int32_t batchSize;
     int32_t channels;
     int32_t height;
     int32_t width;
+    TensorDataType dataType;
+    TensorLayout layout;
+    bool ownsData;              // false なら呼び出し側のバッファを参照（freeBatch で解放しない）
     
-    BatchTensor() : data(nullptr), batchSize(0), channels(3), height(224), width(224) {}
+    BatchTensor()
+        : data(nullptr), batchSize(0), channels(3), height(224), width(224),
+          dataType(TensorDataType::Float32), layout(TensorLayout::NCHW), ownsData(true) {}
     
     size_t size() const { return batchSize * channels * height * width; }
-    size_t sizeBytes() const { return size() * sizeof(float); }
+    size_t sizeBytes() const { return size() * tensorElementSize(dataType); }
+};
+
+/// エラーコード
+enum class VisionError : int32_t {
+    None = 0,
+    InvalidInput = 1,
+    FrameNotDetected = 2,
+    LaneExtractionFailed = 3,
+    TensorConversionFailed = 4,
+    MemoryAllocationFailed = 5,
+    OpenCVError = 6
 };
 
 /// 抽出結果
 struct ExtractionResult {
     bool success;
+    VisionError error;          // success が false のときの失敗理由
     FrameDetectionResult frame;
     std::vector<LaneInfo> lanes;
     BatchTensor tensor;         // 全セル分のテンソル
     int32_t totalCells;
     double preprocessingTimeMs;
     
-    ExtractionResult() : success(false), totalCells(0), preprocessingTimeMs(0) {}
+    ExtractionResult() : success(false), error(VisionError::None), totalCells(0), preprocessingTimeMs(0) {}
+};
+
+/// 適応的二値化の方式
+enum class AdaptiveThresholdMethod : int32_t {
+    Gaussian = 0,   // ガウス重み付き平均（ブロックサイズに比例して重い）
+    Mean = 1,       // 箱平均（OpenCV の boxFilter）
+    Integral = 2    // 積分画像による箱平均（Mean と同じ結果、画素あたり O(1)、行帯で並列化）
 };
 
 /// 前処理設定
 struct PreprocessingConfig {
     // リサイズ
-    int32_t targetLongEdge = 1280;
+    int32_t targetLongEdge = 1280;      // 前処理解像度の上限
+    int32_t detectionLongEdge = 480;    // フレーム検出を行う縮小レベル（0 なら targetLongEdge）
     
     // 色補正
     bool enableWhiteBalance = true;
+    int32_t whiteBalanceSampleStep = 4;  // 平均推定の間引き間隔（1 で全画素）
     bool enableCLAHE = true;
     double claheClipLimit = 2.0;
     int32_t claheTileSize = 8;
@@ -137,8 +232,10 @@ struct PreprocessingConfig {
     double houghMaxLineGap = 10.0;
     
     // 二値化
+    AdaptiveThresholdMethod adaptiveMethod = AdaptiveThresholdMethod::Gaussian;
     int32_t adaptiveBlockSize = 11;
     double adaptiveC = 2.0;
+    int32_t adaptiveThreads = 0;        // Integral の並列数（0: 自動, 1: 単一スレッド）
     
     // モルフォロジー
     int32_t morphKernelSize = 3;
@@ -150,20 +247,21 @@ struct PreprocessingConfig {
     float stdR = 0.229f;
     float stdG = 0.224f;
     float stdB = 0.225f;
+    float meanGray = 0.449f;            // 1 チャンネル出力用（RGB の平均）
+    float stdGray = 0.226f;
     
     // 出力サイズ
     int32_t cellOutputSize = 224;
-};
-
-/// エラーコード
-enum class VisionError : int32_t {
-    None = 0,
-    InvalidInput = 1,
-    FrameNotDetected = 2,
-    LaneExtractionFailed = 3,
-    TensorConversionFailed = 4,
-    MemoryAllocationFailed = 5,
-    OpenCVError = 6
+    TensorDataType tensorDataType = TensorDataType::Float32;  // バッチテンソルの要素型
+    TensorLayout tensorLayout = TensorLayout::NCHW;           // バッチテンソルの配置
+    int32_t tensorChannels = 3;         // 1 なら CLAHE 補正後の輝度のみ (N × 1 × H × W)
+    int32_t conversionThreads = 0;      // セル変換の並列数（0: 自動, 1: 単一スレッド）
+    int32_t parallelMinCells = 16;      // これ未満のセル数は単一スレッドで変換
+    
+    // セル抽出
+    // 正規化フレームを作らず、セルを元画像から直接サンプリング（3 チャンネル時のみ）。
+    // レーン解析は検出レベルの解像度で行うため、境界の精度より速度を優先する場合に有効にする
+    bool enableDirectCellWarp = false;
 };
 
 } // namespace abacus
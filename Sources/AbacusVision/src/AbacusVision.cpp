@@ -2,9 +2,23 @@
 
 #if ABACUS_HAS_OPENCV
 #include <opencv2/imgproc.hpp>
+#include <cmath>
 
 namespace abacus {
 
+namespace {
+
+/// 正規化フレームのサイズ
+constexpr int kWarpWidth = 800;
+constexpr int kWarpHeight = 200;
+
+/// 2 点間の距離
+float distance(const Point& a, const Point& b) {
+    return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+} // namespace
+
 AbacusVision::AbacusVision() : config_() {
     preprocessor_ = std::make_unique<ImagePreprocessor>(config_);
     detector_ = std::make_unique<SorobanDetector>();
@@ -29,19 +43,28 @@ void AbacusVision::setDetectionParams(const SorobanDetector::DetectionParams& pa
     detector_->setParams(params);
 }
 
+void AbacusVision::setConversionExecutor(TensorConverter::Executor executor) {
+    converter_->setExecutor(std::move(executor));
+}
+
+void AbacusVision::setTensorOutput(void* buffer, size_t capacity) {
+    tensorOutput_ = buffer;
+    tensorOutputCapacity_ = buffer ? capacity : 0;
+}
+
 ExtractionResult AbacusVision::processPixelBuffer(const void* pixelBuffer) {
     ExtractionResult result;
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    cv::Mat image;
-    VisionError error = preprocessor_->convertFromPixelBuffer(pixelBuffer, image);
-    
-    if (error != VisionError::None) {
+    // 処理中はロックを保持し、プレーンをコピーせずに参照する（例外時もスコープを出れば解除）
+    PixelBufferLock lock(*preprocessor_, pixelBuffer);
+    if (lock.error() != VisionError::None) {
         result.success = false;
+        result.error = lock.error();
         return result;
     }
     
-    result = processInternal(image);
+    result = processBufferInternal(lock.buffer());
     
     auto endTime = std::chrono::high_resolution_clock::now();
     result.preprocessingTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
@@ -49,6 +72,14 @@ ExtractionResult AbacusVision::processPixelBuffer(const void* pixelBuffer) {
     return result;
 }
 
+ExtractionResult AbacusVision::processBuffer(const ImageBuffer& buffer) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    ExtractionResult result = processBufferInternal(buffer);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.preprocessingTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return result;
+}
+
 ExtractionResult AbacusVision::processImage(const cv::Mat& image) {
     auto startTime = std::chrono::high_resolution_clock::now();
     ExtractionResult result = processInternal(image);
@@ -57,56 +88,261 @@ ExtractionResult AbacusVision::processImage(const cv::Mat& image) {
     return result;
 }
 
+ExtractionResult AbacusVision::processBufferInternal(const ImageBuffer& buffer) {
+    ExtractionResult result;
+    result.success = false;
+    
+    SourceFrame source;
+    VisionError error = preprocessor_->wrapBuffer(buffer, source);
+    if (error != VisionError::None) {
+        result.error = error;
+        return result;
+    }
+    return processInternal(source);
+}
+
 ExtractionResult AbacusVision::processInternal(const cv::Mat& image) {
+    SourceFrame source;
+    if (image.channels() == 1) {
+        source.luma = image;
+    } else {
+        source.image = image;
+        source.toBGR = image.channels() == 4 ? cv::COLOR_BGRA2BGR : -1;
+    }
+    return processInternal(source);
+}
+
+ExtractionResult AbacusVision::processInternal(const SourceFrame& source) {
     ExtractionResult result;
     result.success = false;
     
-    if (image.empty()) return result;
+    if (source.empty()) {
+        result.error = VisionError::InvalidInput;
+        return result;
+    }
     
-    cv::Mat preprocessed, binary, edges;
-    VisionError error = preprocessor_->preprocess(image, preprocessed, binary, edges);
+    // フレーム検出は縮小した検出レベルで行う
+    cv::Mat level;
+    VisionError error = preprocessor_->makeDetectionLevel(source, level);
+    if (error != VisionError::None) {
+        result.error = error;
+        return result;
+    }
+    
+    // キーフレーム間は前回の4隅を追跡し、二値化・輪郭探索を省略する
+    FrameDetectionResult frame = trackLastFrame(source, level);
     
-    if (error != VisionError::None) return result;
+    if (frame.detected) {
+        ++framesSinceKeyframe_;
+    } else {
+        cv::Mat preprocessed, binary, edges;
+        if (source.isLuma()) {
+            error = preprocessor_->preprocessLuma(level, workspace_, binary, edges);
+            preprocessed = level;
+        } else {
+            error = preprocessor_->preprocess(level, workspace_, preprocessed, binary, edges);
+        }
+        
+        if (error != VisionError::None) {
+            result.error = error;
+            return result;
+        }
+        
+        frame = detector_->detectFrame(preprocessed, binary, edges);
+        framesSinceKeyframe_ = 0;
+    }
     
-    FrameDetectionResult frame = detector_->detectFrame(preprocessed, binary, edges);
+    // 検出結果を元解像度の座標系に戻す
+    float sx = static_cast<float>(source.width()) / level.cols;
+    float sy = static_cast<float>(source.height()) / level.rows;
+    frame.corners = scaleQuadrilateral(frame.corners, sx, sy);
+    frame.boundingBox = Rect(
+        frame.boundingBox.x * sx,
+        frame.boundingBox.y * sy,
+        frame.boundingBox.width * sx,
+        frame.boundingBox.height * sy
+    );
     lastFrame_ = frame;
+    trackedWidth_ = source.width();
+    trackedHeight_ = source.height();
     result.frame = frame;
     
-    if (!frame.detected) return result;
+    if (!frame.detected) {
+        result.error = VisionError::FrameNotDetected;
+        return result;
+    }
+    
+    if (config_.tensorChannels == 1) {
+        extractLuminance(source, result);
+        return result;
+    }
+    
+    if (config_.enableDirectCellWarp) {
+        extractDirect(source, level, result);
+        return result;
+    }
+    
+    // セルは元解像度から切り出す（色差・色変換は正規化後のフレームでのみ行う）
+    cv::Mat warped = detector_->warpFrame(source, frame, kWarpWidth, kWarpHeight);
+    if (warped.empty()) {
+        result.error = VisionError::LaneExtractionFailed;
+        return result;
+    }
+    preprocessor_->applyWhiteBalance(warped, warped);
     
-    cv::Mat warped = detector_->warpFrame(preprocessed, frame, 800, 200);
-    if (warped.empty()) return result;
+    extractFromWarped(warped, result);
+    return result;
+}
+
+FrameDetectionResult AbacusVision::trackLastFrame(const SourceFrame& source, const cv::Mat& level) {
+    FrameDetectionResult previous = lastFrame_;
+    previous.detected = false;
+    
+    const SorobanDetector::DetectionParams& params = detector_->getParams();
+    if (!params.enableTracking || !lastFrame_.detected ||
+        framesSinceKeyframe_ >= params.trackingKeyframeInterval ||
+        source.width() != trackedWidth_ || source.height() != trackedHeight_) {
+        return previous;
+    }
     
-    int laneCount = detector_->detectLaneCount(warped);
-    result.frame.laneCount = laneCount;
-    if (laneCount <= 0) return result;
+    const cv::Mat& gray = source.isLuma() ? level : preprocessor_->toGrayscale(level, workspace_.gray);
     
-    std::vector<LaneInfo> lanes = detector_->extractLanes(warped, laneCount);
-    result.lanes = lanes;
+    // 前回の結果を検出レベルの座標系に移す
+    previous.detected = true;
+    previous.corners = scaleQuadrilateral(
+        lastFrame_.corners,
+        static_cast<float>(level.cols) / source.width(),
+        static_cast<float>(level.rows) / source.height()
+    );
+    return detector_->trackFrame(gray, previous);
+}
+
+void AbacusVision::extractDirect(const SourceFrame& source, const cv::Mat& level, ExtractionResult& result) {
+    // 元解像度の画像を直接サンプリングするため、不正な四隅は OpenCV の例外になり得る
+    try {
+        // レーン解析は検出レベルから作った正規化画像で行う
+        FrameDetectionResult levelFrame = result.frame;
+        levelFrame.corners = scaleQuadrilateral(
+            result.frame.corners,
+            static_cast<float>(level.cols) / source.width(),
+            static_cast<float>(level.rows) / source.height()
+        );
+        const cv::Mat& levelGray = source.isLuma() ? level : preprocessor_->toGrayscale(level, workspace_.gray);
+        cv::Mat analysis = detector_->warpLevelFrame(levelGray, levelFrame, kWarpWidth, kWarpHeight);
+        if (analysis.empty()) {
+            result.error = VisionError::LaneExtractionFailed;
+            return;
+        }
+        
+        result.lanes = detector_->detectLanes(analysis);
+        result.frame.laneCount = static_cast<int32_t>(result.lanes.size());
+        if (result.lanes.empty()) {
+            result.error = VisionError::LaneExtractionFailed;
+            return;
+        }
+        
+        std::vector<cv::Rect> cellRects;
+        cellRects.reserve(result.lanes.size() * SorobanDetector::kCellsPerLane);
+        for (const LaneInfo& lane : result.lanes) {
+            cv::Rect roi(
+                static_cast<int>(lane.boundingBox.x),
+                static_cast<int>(lane.boundingBox.y),
+                static_cast<int>(lane.boundingBox.width),
+                static_cast<int>(lane.boundingBox.height)
+            );
+            std::vector<cv::Rect> rects = detector_->computeCellRects(roi);
+            cellRects.insert(cellRects.end(), rects.begin(), rects.end());
+        }
+        
+        // 各セルを元解像度から cellOutputSize へ 1 回の補間でサンプリング
+        detector_->warpCells(
+            source, result.frame, kWarpWidth, kWarpHeight,
+            cellRects, config_.cellOutputSize, cells_
+        );
+        preprocessor_->applyWhiteBalance(cells_);
+        
+        result.totalCells = static_cast<int32_t>(cells_.size());
+        
+        if (!cells_.empty()) {
+            VisionError error = convertCells(cells_, result.tensor);
+            if (error != VisionError::None) {
+                result.error = error;
+                return;
+            }
+        }
+        
+        result.success = true;
+    } catch (const cv::Exception&) {
+        result.error = VisionError::OpenCVError;
+    }
+}
+
+void AbacusVision::extractLuminance(const SourceFrame& source, ExtractionResult& result) {
+    // YUV / Gray は Y プレーンだけを変換し、色差の変換と色変換を省く
+    cv::Mat warped;
+    if (source.isLuma()) {
+        warped = detector_->warpFrame(source.luma, result.frame, kWarpWidth, kWarpHeight);
+    } else {
+        warped = preprocessor_->toGrayscale(detector_->warpFrame(source, result.frame, kWarpWidth, kWarpHeight));
+    }
+    if (warped.empty()) {
+        result.error = VisionError::LaneExtractionFailed;
+        return;
+    }
+    
+    // フレーム検出と同じ大きさのタイルで CLAHE 補正してからセルを切り出す
+    const Quadrilateral& corners = result.frame.corners;
+    double coverageX = 0.5 * (distance(corners.topLeft, corners.topRight) +
+                              distance(corners.bottomLeft, corners.bottomRight)) / source.width();
+    double coverageY = 0.5 * (distance(corners.topLeft, corners.bottomLeft) +
+                              distance(corners.topRight, corners.bottomRight)) / source.height();
+    const cv::Mat& enhanced = preprocessor_->applyCLAHE(warped, coverageX, coverageY, enhancedFrame_);
+    extractFromWarped(enhanced, result);
+}
+
+void AbacusVision::extractFromWarped(const cv::Mat& warped, ExtractionResult& result) {
+    result.lanes = detector_->detectLanes(warped);
+    result.frame.laneCount = static_cast<int32_t>(result.lanes.size());
+    if (result.lanes.empty()) {
+        result.error = VisionError::LaneExtractionFailed;
+        return;
+    }
     
-    std::vector<cv::Mat> allCells;
-    for (size_t i = 0; i < lanes.size(); ++i) {
-        LaneInfo& lane = result.lanes[i];
+    // セルは warped への ROI として集め、画素は変換器が読むときに初めて触れる
+    cellViews_.clear();
+    cellViews_.reserve(result.lanes.size() * SorobanDetector::kCellsPerLane);
+    for (LaneInfo& lane : result.lanes) {
         cv::Rect roi(
             static_cast<int>(lane.boundingBox.x),
             static_cast<int>(lane.boundingBox.y),
             static_cast<int>(lane.boundingBox.width),
             static_cast<int>(lane.boundingBox.height)
         );
-        cv::Mat laneImage = warped(roi);
-        std::vector<cv::Mat> cells = detector_->extractCells(laneImage, lane);
-        allCells.insert(allCells.end(), cells.begin(), cells.end());
+        detector_->extractCells(warped(roi), lane, cellViews_);
     }
     
-    result.totalCells = static_cast<int32_t>(allCells.size());
+    result.totalCells = static_cast<int32_t>(cellViews_.size());
+    
+    VisionError error = VisionError::None;
+    if (!cellViews_.empty()) {
+        error = convertCells(cellViews_, result.tensor);
+    }
     
-    if (!allCells.empty()) {
-        error = converter_->convertBatch(allCells, result.tensor);
-        if (error != VisionError::None) return result;
+    // フレームへの参照を次の処理まで持ち越さない
+    cellViews_.clear();
+    if (error != VisionError::None) {
+        result.error = error;
+        return;
     }
     
     result.success = true;
-    return result;
+}
+
+VisionError AbacusVision::convertCells(const std::vector<cv::Mat>& cells, BatchTensor& tensor) {
+    if (tensorOutput_) {
+        return converter_->convertBatch(cells, tensorOutput_, tensorOutputCapacity_, tensor);
+    }
+    return converter_->convertBatch(cells, tensor);
 }
 
 cv::Mat AbacusVision::drawDebugOverlay(const cv::Mat& original, const ExtractionResult& result) {
@@ -158,8 +394,22 @@ int32_t abacus_vision_process(void* instance, const void* pixelBuffer, abacus::E
     abacus::AbacusVision* vision = static_cast<abacus::AbacusVision*>(instance);
     *result = vision->processPixelBuffer(pixelBuffer);
     
-    return result->success ? static_cast<int32_t>(abacus::VisionError::None)
-                           : static_cast<int32_t>(abacus::VisionError::FrameNotDetected);
+    if (result->success) return static_cast<int32_t>(abacus::VisionError::None);
+    return static_cast<int32_t>(result->error != abacus::VisionError::None
+                                    ? result->error : abacus::VisionError::FrameNotDetected);
+}
+
+int32_t abacus_vision_process_buffer(void* instance, const abacus::ImageBuffer* buffer, abacus::ExtractionResult* result) {
+    if (!instance || !buffer || !result) {
+        return static_cast<int32_t>(abacus::VisionError::InvalidInput);
+    }
+    
+    abacus::AbacusVision* vision = static_cast<abacus::AbacusVision*>(instance);
+    *result = vision->processBuffer(*buffer);
+    
+    if (result->success) return static_cast<int32_t>(abacus::VisionError::None);
+    return static_cast<int32_t>(result->error != abacus::VisionError::None
+                                    ? result->error : abacus::VisionError::FrameNotDetected);
 }
 
 void abacus_vision_free_result(abacus::ExtractionResult* result) {
@@ -169,6 +419,12 @@ void abacus_vision_free_result(abacus::ExtractionResult* result) {
     }
 }
 
+void abacus_vision_set_tensor_output(void* instance, void* buffer, size_t capacity) {
+    if (instance) {
+        static_cast<abacus::AbacusVision*>(instance)->setTensorOutput(buffer, capacity);
+    }
+}
+
 void abacus_vision_set_config(void* instance, const abacus::PreprocessingConfig* config) {
     if (instance && config) {
         static_cast<abacus::AbacusVision*>(instance)->setConfig(*config);
@@ -192,9 +448,24 @@ AbacusVision::AbacusVision(const PreprocessingConfig&) : config_() {}
 AbacusVision::~AbacusVision() = default;
 void AbacusVision::setConfig(const PreprocessingConfig&) {}
 void AbacusVision::setDetectionParams(const SorobanDetector::DetectionParams&) {}
+void AbacusVision::setConversionExecutor(TensorConverter::Executor) {}
+void AbacusVision::setTensorOutput(void*, size_t) {}
 ExtractionResult AbacusVision::processPixelBuffer(const void*) { ExtractionResult r; r.success = false; return r; }
+ExtractionResult AbacusVision::processBuffer(const ImageBuffer&) { ExtractionResult r; r.success = false; return r; }
 ExtractionResult AbacusVision::processImage(const cv::Mat&) { ExtractionResult r; r.success = false; return r; }
 ExtractionResult AbacusVision::processInternal(const cv::Mat&) { ExtractionResult r; r.success = false; return r; }
+ExtractionResult AbacusVision::processBufferInternal(const ImageBuffer&) { ExtractionResult r; r.success = false; return r; }
+ExtractionResult AbacusVision::processInternal(const SourceFrame&) { ExtractionResult r; r.success = false; return r; }
+
+FrameDetectionResult AbacusVision::trackLastFrame(const SourceFrame&, const cv::Mat&) {
+    FrameDetectionResult r = lastFrame_;
+    r.detected = false;
+    return r;
+}
+void AbacusVision::extractDirect(const SourceFrame&, const cv::Mat&, ExtractionResult&) {}
+void AbacusVision::extractLuminance(const SourceFrame&, ExtractionResult&) {}
+void AbacusVision::extractFromWarped(const cv::Mat&, ExtractionResult&) {}
+VisionError AbacusVision::convertCells(const std::vector<cv::Mat>&, BatchTensor&) { return VisionError::OpenCVError; }
 cv::Mat AbacusVision::drawDebugOverlay(const cv::Mat& o, const ExtractionResult&) { return o; }
 
 } // namespace abacus
@@ -204,7 +475,9 @@ extern "C" {
 void* abacus_vision_create(void) { return nullptr; }
 void abacus_vision_destroy(void*) {}
 int32_t abacus_vision_process(void*, const void*, abacus::ExtractionResult*) { return -1; }
+int32_t abacus_vision_process_buffer(void*, const abacus::ImageBuffer*, abacus::ExtractionResult*) { return -1; }
 void abacus_vision_free_result(abacus::ExtractionResult*) {}
+void abacus_vision_set_tensor_output(void*, void*, size_t) {}
 void abacus_vision_set_config(void*, const abacus::PreprocessingConfig*) {}
 void abacus_vision_set_detection_params(void*, const abacus::SorobanDetector::DetectionParams*) {}
 
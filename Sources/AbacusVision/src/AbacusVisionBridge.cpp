@@ -43,6 +43,130 @@ ABFrameResult convertFrameResult(const abacus::FrameDetectionResult& f) {
     return result;
 }
 
+/// abacus::PreprocessingConfig → ABVisionConfig 変換
+ABVisionConfig convertConfig(const abacus::PreprocessingConfig& c) {
+    ABVisionConfig result;
+    result.targetLongEdge = c.targetLongEdge;
+    result.detectionLongEdge = c.detectionLongEdge;
+    result.enableWhiteBalance = c.enableWhiteBalance;
+    result.enableCLAHE = c.enableCLAHE;
+    result.claheClipLimit = c.claheClipLimit;
+    result.claheTileSize = c.claheTileSize;
+    result.enableGaussianBlur = c.enableGaussianBlur;
+    result.adaptiveMethod = static_cast<ABAdaptiveThresholdMethod>(c.adaptiveMethod);
+    result.adaptiveBlockSize = c.adaptiveBlockSize;
+    result.adaptiveC = c.adaptiveC;
+    result.adaptiveThreads = c.adaptiveThreads;
+    result.mean[0] = c.meanR;
+    result.mean[1] = c.meanG;
+    result.mean[2] = c.meanB;
+    result.std[0] = c.stdR;
+    result.std[1] = c.stdG;
+    result.std[2] = c.stdB;
+    result.meanGray = c.meanGray;
+    result.stdGray = c.stdGray;
+    result.cellOutputSize = c.cellOutputSize;
+    result.tensorDataType = static_cast<ABTensorDataType>(c.tensorDataType);
+    result.tensorLayout = static_cast<ABTensorLayout>(c.tensorLayout);
+    result.tensorChannels = c.tensorChannels;
+    result.conversionThreads = c.conversionThreads;
+    result.parallelMinCells = c.parallelMinCells;
+    result.enableDirectCellWarp = c.enableDirectCellWarp;
+    return result;
+}
+
+/// ABVisionConfig の値が前処理で扱える範囲かを確認
+bool isValidConfig(const ABVisionConfig& c) {
+    for (int i = 0; i < 3; ++i) {
+        if (!(c.std[i] > 0.0f)) return false;
+    }
+    return c.targetLongEdge > 0 && c.detectionLongEdge >= 0 &&
+        c.claheClipLimit > 0.0 && c.claheTileSize > 0 &&
+        c.adaptiveMethod >= ABAdaptiveThresholdGaussian && c.adaptiveMethod <= ABAdaptiveThresholdIntegral &&
+        c.adaptiveBlockSize >= 3 && c.adaptiveThreads >= 0 &&
+        c.stdGray > 0.0f && c.cellOutputSize > 0 &&
+        c.tensorDataType >= ABTensorDataTypeFloat32 && c.tensorDataType <= ABTensorDataTypeUInt8 &&
+        (c.tensorLayout == ABTensorLayoutNCHW || c.tensorLayout == ABTensorLayoutNHWC) &&
+        (c.tensorChannels == 1 || c.tensorChannels == 3) &&
+        c.conversionThreads >= 0 && c.parallelMinCells >= 0;
+}
+
+/// ABVisionConfig の項目を abacus::PreprocessingConfig に書き込む（対応しない項目はそのまま）
+void applyConfig(const ABVisionConfig& c, abacus::PreprocessingConfig& result) {
+    result.targetLongEdge = c.targetLongEdge;
+    result.detectionLongEdge = c.detectionLongEdge;
+    result.enableWhiteBalance = c.enableWhiteBalance;
+    result.enableCLAHE = c.enableCLAHE;
+    result.claheClipLimit = c.claheClipLimit;
+    result.claheTileSize = c.claheTileSize;
+    result.enableGaussianBlur = c.enableGaussianBlur;
+    result.adaptiveMethod = static_cast<abacus::AdaptiveThresholdMethod>(c.adaptiveMethod);
+    result.adaptiveBlockSize = c.adaptiveBlockSize;
+    result.adaptiveC = c.adaptiveC;
+    result.adaptiveThreads = c.adaptiveThreads;
+    result.meanR = c.mean[0];
+    result.meanG = c.mean[1];
+    result.meanB = c.mean[2];
+    result.stdR = c.std[0];
+    result.stdG = c.std[1];
+    result.stdB = c.std[2];
+    result.meanGray = c.meanGray;
+    result.stdGray = c.stdGray;
+    result.cellOutputSize = c.cellOutputSize;
+    result.tensorDataType = static_cast<abacus::TensorDataType>(c.tensorDataType);
+    result.tensorLayout = static_cast<abacus::TensorLayout>(c.tensorLayout);
+    result.tensorChannels = c.tensorChannels;
+    result.conversionThreads = c.conversionThreads;
+    result.parallelMinCells = c.parallelMinCells;
+    result.enableDirectCellWarp = c.enableDirectCellWarp;
+}
+
+/// abacus::ExtractionResult → ABExtractionResult 変換
+/// テンソルはコピーせず、所有権ごと result に移す。
+/// @return エラーコード（失敗時は処理段が報告した理由）
+int32_t fillResult(abacus::ExtractionResult& cppResult, ABExtractionResult* result) {
+    if (!cppResult.success) {
+        return cppResult.error != abacus::VisionError::None
+            ? static_cast<int32_t>(cppResult.error)
+            : ABVisionErrorFrameNotDetected;
+    }
+    
+    // 基本情報をコピー
+    result->success = true;
+    result->frame = convertFrameResult(cppResult.frame);
+    result->totalCells = cppResult.totalCells;
+    result->preprocessingTimeMs = cppResult.preprocessingTimeMs;
+    
+    // レーン配列をコピー
+    result->laneCount = static_cast<int32_t>(cppResult.lanes.size());
+    if (result->laneCount > 0) {
+        result->lanes = new ABLaneInfo[result->laneCount];
+        for (size_t i = 0; i < cppResult.lanes.size(); ++i) {
+            const auto& lane = cppResult.lanes[i];
+            result->lanes[i].boundingBox = convertRect(lane.boundingBox);
+            result->lanes[i].digitIndex = lane.digitIndex;
+            result->lanes[i].value = lane.value;
+            result->lanes[i].confidence = lane.confidence;
+        }
+    }
+    
+    // テンソルデータを移す
+    auto& tensor = cppResult.tensor;
+    if (tensor.data && tensor.batchSize > 0) {
+        result->tensorData = tensor.data;
+        result->tensorDataType = static_cast<ABTensorDataType>(tensor.dataType);
+        result->tensorLayout = static_cast<ABTensorLayout>(tensor.layout);
+        result->tensorOwned = tensor.ownsData;
+        tensor.data = nullptr;
+        result->tensorBatchSize = tensor.batchSize;
+        result->tensorChannels = tensor.channels;
+        result->tensorHeight = tensor.height;
+        result->tensorWidth = tensor.width;
+    }
+    
+    return ABVisionErrorNone;
+}
+
 } // anonymous namespace
 
 // ============================================================
@@ -81,44 +205,72 @@ int32_t ab_vision_process(
     try {
         abacus::AbacusVision* vision = static_cast<abacus::AbacusVision*>(instance);
         abacus::ExtractionResult cppResult = vision->processPixelBuffer(pixelBuffer);
-        
-        if (!cppResult.success) {
-            return ABVisionErrorFrameNotDetected;
-        }
-        
-        // 基本情報をコピー
-        result->success = true;
-        result->frame = convertFrameResult(cppResult.frame);
-        result->totalCells = cppResult.totalCells;
-        result->preprocessingTimeMs = cppResult.preprocessingTimeMs;
-        
-        // レーン配列をコピー
-        result->laneCount = static_cast<int32_t>(cppResult.lanes.size());
-        if (result->laneCount > 0) {
-            result->lanes = new ABLaneInfo[result->laneCount];
-            for (size_t i = 0; i < cppResult.lanes.size(); ++i) {
-                const auto& lane = cppResult.lanes[i];
-                result->lanes[i].boundingBox = convertRect(lane.boundingBox);
-                result->lanes[i].digitIndex = lane.digitIndex;
-                result->lanes[i].value = lane.value;
-                result->lanes[i].confidence = lane.confidence;
-            }
-        }
-        
-        // テンソルデータをコピー
-        const auto& tensor = cppResult.tensor;
-        if (tensor.data && tensor.batchSize > 0) {
-            size_t tensorSize = tensor.size();
-            result->tensorData = new float[tensorSize];
-            std::memcpy(result->tensorData, tensor.data, tensor.sizeBytes());
-            result->tensorBatchSize = tensor.batchSize;
-            result->tensorChannels = tensor.channels;
-            result->tensorHeight = tensor.height;
-            result->tensorWidth = tensor.width;
+        int32_t error = fillResult(cppResult, result);
+        abacus::TensorConverter::freeBatch(cppResult.tensor);
+        return error;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_vision_process_buffer(
+    void* instance,
+    const ABImageBuffer* buffer,
+    ABExtractionResult* result
+) {
+    if (!instance || !buffer || !buffer->data || !result || buffer->width <= 0 || buffer->height <= 0) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    // 結果を初期化
+    *result = ABExtractionResult{};
+    result->success = false;
+    
+    try {
+        abacus::AbacusVision* vision = static_cast<abacus::AbacusVision*>(instance);
+        abacus::ImageBuffer desc(
+            buffer->data, buffer->width, buffer->height, buffer->bytesPerRow,
+            static_cast<abacus::PixelFormat>(buffer->format)
+        );
+        for (int i = 0; i < 2; ++i) {
+            desc.chromaData[i] = buffer->chromaData[i];
+            desc.chromaBytesPerRow[i] = buffer->chromaBytesPerRow[i];
         }
-        
+        abacus::ExtractionResult cppResult = vision->processBuffer(desc);
+        int32_t error = fillResult(cppResult, result);
+        abacus::TensorConverter::freeBatch(cppResult.tensor);
+        return error;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+void ab_vision_set_tensor_output(void* instance, void* buffer, size_t capacity) {
+    if (instance) {
+        static_cast<abacus::AbacusVision*>(instance)->setTensorOutput(buffer, capacity);
+    }
+}
+
+int32_t ab_vision_get_config(void* instance, ABVisionConfig* config) {
+    if (!instance || !config) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    *config = convertConfig(static_cast<abacus::AbacusVision*>(instance)->getConfig());
+    return ABVisionErrorNone;
+}
+
+int32_t ab_vision_set_config(void* instance, const ABVisionConfig* config) {
+    if (!instance || !config || !isValidConfig(*config)) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    try {
+        abacus::AbacusVision* vision = static_cast<abacus::AbacusVision*>(instance);
+        abacus::PreprocessingConfig updated = vision->getConfig();
+        applyConfig(*config, updated);
+        vision->setConfig(updated);
         return ABVisionErrorNone;
-        
     } catch (...) {
         return ABVisionErrorOpenCVError;
     }
@@ -133,7 +285,9 @@ void ab_vision_free_result(ABExtractionResult* result) {
     }
     
     if (result->tensorData) {
-        delete[] result->tensorData;
+        if (result->tensorOwned) {
+            abacus::TensorPool::shared().release(result->tensorData);
+        }
         result->tensorData = nullptr;
     }
     
@@ -168,6 +322,30 @@ int32_t ab_vision_process(
     return ABVisionErrorOpenCVError;
 }
 
+int32_t ab_vision_process_buffer(
+    void* /* instance */,
+    const ABImageBuffer* /* buffer */,
+    ABExtractionResult* result
+) {
+    if (result) {
+        *result = ABExtractionResult{};
+        result->success = false;
+    }
+    return ABVisionErrorOpenCVError;
+}
+
+void ab_vision_set_tensor_output(void* /* instance */, void* /* buffer */, size_t /* capacity */) {
+    // No-op
+}
+
+int32_t ab_vision_get_config(void* /* instance */, ABVisionConfig* /* config */) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_vision_set_config(void* /* instance */, const ABVisionConfig* /* config */) {
+    return ABVisionErrorOpenCVError;
+}
+
 void ab_vision_free_result(ABExtractionResult* /* result */) {
     // No-op
 }
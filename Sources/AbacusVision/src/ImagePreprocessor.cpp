@@ -3,10 +3,48 @@
 #if ABACUS_HAS_OPENCV
 #include <opencv2/imgproc.hpp>
 #include <opencv2/photo.hpp>
+#if defined(__APPLE__)
 #include <CoreVideo/CoreVideo.h>
+#endif
+#include <climits>
 
 namespace abacus {
 
+namespace {
+
+/// 積分画像から窓の総和を求めて二値化（Sum は積分画像の要素型）
+/// 積は画像サイズ・窓幅によって int を超えるので 64 ビットで比較する。
+template <typename Sum>
+void thresholdRows(
+    const cv::Mat& gray,
+    const cv::Mat& sums,
+    int blockSize,
+    int delta,
+    const cv::Range& range,
+    cv::Mat& output
+) {
+    const int cols = gray.cols;
+    const int64_t area = static_cast<int64_t>(blockSize) * blockSize;
+    
+    for (int y = range.start; y < range.end; ++y) {
+        const Sum* top = sums.ptr<Sum>(y);
+        const Sum* bottom = sums.ptr<Sum>(y + blockSize);
+        const Sum* topRight = top + blockSize;
+        const Sum* bottomRight = bottom + blockSize;
+        const uint8_t* src = gray.ptr<uint8_t>(y);
+        uint8_t* dst = output.ptr<uint8_t>(y);
+        
+        // 窓幅が一定なので、内側ループは分岐なしでベクトル化できる
+        for (int x = 0; x < cols; ++x) {
+            const int64_t sum = static_cast<int64_t>(bottomRight[x] - bottom[x] - topRight[x] + top[x]);
+            const int above = (2 * (src[x] + static_cast<int64_t>(delta)) - 1) * area > 2 * sum;
+            dst[x] = static_cast<uint8_t>(-above & 255);
+        }
+    }
+}
+
+} // namespace
+
 ImagePreprocessor::ImagePreprocessor() : config_() {
     initCLAHE();
 }
@@ -27,162 +65,561 @@ void ImagePreprocessor::initCLAHE() {
         config_.claheClipLimit,
         cv::Size(config_.claheTileSize, config_.claheTileSize)
     );
+    regionClahe_ = cv::createCLAHE(config_.claheClipLimit);
+    morphKernel_ = cv::getStructuringElement(
+        cv::MORPH_RECT,
+        cv::Size(config_.morphKernelSize, config_.morphKernelSize)
+    );
 }
 
-VisionError ImagePreprocessor::convertFromPixelBuffer(const void* pixelBuffer, cv::Mat& output) {
+VisionError ImagePreprocessor::lockPixelBuffer(const void* pixelBuffer, ImageBuffer& desc) {
+#if defined(__APPLE__)
     if (!pixelBuffer) {
         return VisionError::InvalidInput;
     }
     
     CVPixelBufferRef buffer = (CVPixelBufferRef)pixelBuffer;
+    PixelFormat format;
+    
+    switch (CVPixelBufferGetPixelFormatType(buffer)) {
+        case kCVPixelFormatType_32BGRA:
+            format = PixelFormat::BGRA;
+            break;
+        case kCVPixelFormatType_32RGBA:
+            format = PixelFormat::RGBA;
+            break;
+        case kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange:
+        case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange:
+            format = PixelFormat::NV12;
+            break;
+        case kCVPixelFormatType_420YpCbCr8Planar:
+        case kCVPixelFormatType_420YpCbCr8PlanarFullRange:
+            format = PixelFormat::I420;
+            break;
+        default:
+            return VisionError::InvalidInput;
+    }
+    
     CVPixelBufferLockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
     
-    size_t width = CVPixelBufferGetWidth(buffer);
-    size_t height = CVPixelBufferGetHeight(buffer);
-    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(buffer);
-    void* baseAddress = CVPixelBufferGetBaseAddress(buffer);
-    OSType pixelFormat = CVPixelBufferGetPixelFormatType(buffer);
+    desc = ImageBuffer(
+        nullptr,
+        static_cast<int32_t>(CVPixelBufferGetWidth(buffer)),
+        static_cast<int32_t>(CVPixelBufferGetHeight(buffer)),
+        0,
+        format
+    );
     
-    if (!baseAddress) {
+    if (CVPixelBufferIsPlanar(buffer)) {
+        size_t planeCount = CVPixelBufferGetPlaneCount(buffer);
+        desc.data = CVPixelBufferGetBaseAddressOfPlane(buffer, 0);
+        desc.bytesPerRow = CVPixelBufferGetBytesPerRowOfPlane(buffer, 0);
+        for (size_t i = 1; i < planeCount && i <= 2; ++i) {
+            desc.chromaData[i - 1] = CVPixelBufferGetBaseAddressOfPlane(buffer, i);
+            desc.chromaBytesPerRow[i - 1] = CVPixelBufferGetBytesPerRowOfPlane(buffer, i);
+        }
+    } else {
+        desc.data = CVPixelBufferGetBaseAddress(buffer);
+        desc.bytesPerRow = CVPixelBufferGetBytesPerRow(buffer);
+    }
+    
+    if (!desc.data) {
         CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
         return VisionError::InvalidInput;
     }
+    return VisionError::None;
+#else
+    (void)pixelBuffer;
+    (void)desc;
+    return VisionError::InvalidInput;
+#endif
+}
+
+void ImagePreprocessor::unlockPixelBuffer(const void* pixelBuffer) {
+#if defined(__APPLE__)
+    if (pixelBuffer) {
+        CVPixelBufferUnlockBaseAddress((CVPixelBufferRef)pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    }
+#else
+    (void)pixelBuffer;
+#endif
+}
+
+VisionError ImagePreprocessor::convertFromPixelBuffer(const void* pixelBuffer, cv::Mat& output) {
+    PixelBufferLock lock(*this, pixelBuffer);
+    if (lock.error() != VisionError::None) {
+        return lock.error();
+    }
     
-    cv::Mat temp;
+    // CVPixelBuffer は常に作業バッファへ変換されるため、ロック解除後も output は有効
+    return convertFromBuffer(lock.buffer(), output);
+}
+
+VisionError ImagePreprocessor::convertFromBuffer(const ImageBuffer& buffer, cv::Mat& output) {
+    SourceFrame source;
+    VisionError error = wrapBuffer(buffer, source);
+    if (error != VisionError::None) {
+        return error;
+    }
     
-    if (pixelFormat == kCVPixelFormatType_32BGRA) {
-        temp = cv::Mat(static_cast<int>(height), static_cast<int>(width), CV_8UC4, baseAddress, bytesPerRow);
-        cv::cvtColor(temp, output, cv::COLOR_BGRA2BGR);
-    } else if (pixelFormat == kCVPixelFormatType_32RGBA) {
-        temp = cv::Mat(static_cast<int>(height), static_cast<int>(width), CV_8UC4, baseAddress, bytesPerRow);
-        cv::cvtColor(temp, output, cv::COLOR_RGBA2BGR);
-    } else {
-        CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
+    try {
+        if (source.isLuma()) {
+            cv::Mat luma, chroma;
+            resizePlanes(source, config_.targetLongEdge, luma, chroma);
+            if (chroma.empty()) {
+                cv::cvtColor(luma, ingestBuffer_, cv::COLOR_GRAY2BGR);
+            } else {
+                cv::cvtColorTwoPlane(luma, chroma, ingestBuffer_, cv::COLOR_YUV2BGR_NV12);
+            }
+            output = ingestBuffer_;
+        } else {
+            resizeAndConvert(source.image, source.toBGR, config_.targetLongEdge, output);
+        }
+    } catch (const cv::Exception&) {
+        return VisionError::OpenCVError;
+    }
+    return VisionError::None;
+}
+
+VisionError ImagePreprocessor::wrapBuffer(const ImageBuffer& buffer, SourceFrame& source) {
+    if (!buffer.data || buffer.width <= 0 || buffer.height <= 0) {
+        return VisionError::InvalidInput;
+    }
+    
+    source = SourceFrame();
+    uint8_t* base = static_cast<uint8_t*>(const_cast<void*>(buffer.data));
+    
+    if (!isLumaFormat(buffer.format)) {
+        int type;
+        switch (buffer.format) {
+            case PixelFormat::BGRA: type = CV_8UC4; source.toBGR = cv::COLOR_BGRA2BGR; break;
+            case PixelFormat::RGBA: type = CV_8UC4; source.toBGR = cv::COLOR_RGBA2BGR; break;
+            case PixelFormat::BGR:  type = CV_8UC3; source.toBGR = -1; break;
+            case PixelFormat::RGB:  type = CV_8UC3; source.toBGR = cv::COLOR_RGB2BGR; break;
+            default: return VisionError::InvalidInput;
+        }
+        
+        // bytesPerRow == 0 は cv::Mat::AUTO_STEP と同じ扱い
+        size_t rowBytes = static_cast<size_t>(buffer.width) * CV_ELEM_SIZE(type);
+        if (buffer.bytesPerRow != 0 && buffer.bytesPerRow < rowBytes) {
+            return VisionError::InvalidInput;
+        }
+        
+        try {
+            source.image = cv::Mat(buffer.height, buffer.width, type, base, buffer.bytesPerRow);
+        } catch (const cv::Exception&) {
+            return VisionError::InvalidInput;
+        }
+        return VisionError::None;
+    }
+    
+    if (buffer.width < 2 || buffer.height < 2) {
+        return VisionError::InvalidInput;
+    }
+    
+    // 4:2:0 の色差と揃えるため偶数サイズに切り詰める
+    int width = buffer.width & ~1;
+    int height = buffer.height & ~1;
+    int chromaWidth = (buffer.width + 1) / 2;
+    int chromaHeight = (buffer.height + 1) / 2;
+    cv::Rect half(0, 0, width / 2, height / 2);
+    
+    size_t lumaStride = buffer.bytesPerRow != 0 ? buffer.bytesPerRow : static_cast<size_t>(buffer.width);
+    if (lumaStride < static_cast<size_t>(buffer.width)) {
         return VisionError::InvalidInput;
     }
     
-    output = output.clone();
-    CVPixelBufferUnlockBaseAddress(buffer, kCVPixelBufferLock_ReadOnly);
+    try {
+        source.luma = cv::Mat(height, width, CV_8UC1, base, lumaStride);
+        
+        if (buffer.format == PixelFormat::NV12) {
+            uint8_t* uvBase = buffer.chromaData[0]
+                ? static_cast<uint8_t*>(const_cast<void*>(buffer.chromaData[0]))
+                : base + lumaStride * buffer.height;
+            size_t uvStride = buffer.chromaBytesPerRow[0] != 0 ? buffer.chromaBytesPerRow[0] : lumaStride;
+            if (uvStride < static_cast<size_t>(chromaWidth) * 2) {
+                return VisionError::InvalidInput;
+            }
+            source.chroma = cv::Mat(chromaHeight, chromaWidth, CV_8UC2, uvBase, uvStride)(half);
+        } else if (buffer.format == PixelFormat::I420) {
+            uint8_t* uBase = buffer.chromaData[0]
+                ? static_cast<uint8_t*>(const_cast<void*>(buffer.chromaData[0]))
+                : base + lumaStride * buffer.height;
+            size_t uStride = buffer.chromaBytesPerRow[0] != 0 ? buffer.chromaBytesPerRow[0] : lumaStride / 2;
+            uint8_t* vBase = buffer.chromaData[1]
+                ? static_cast<uint8_t*>(const_cast<void*>(buffer.chromaData[1]))
+                : uBase + uStride * chromaHeight;
+            size_t vStride = buffer.chromaBytesPerRow[1] != 0 ? buffer.chromaBytesPerRow[1] : uStride;
+            if (uStride < static_cast<size_t>(chromaWidth) || vStride < static_cast<size_t>(chromaWidth)) {
+                return VisionError::InvalidInput;
+            }
+            
+            // U / V はその場で参照し、UV へのまとめは変換後の小さな画像でのみ行う
+            source.chroma = cv::Mat(chromaHeight, chromaWidth, CV_8UC1, uBase, uStride)(half);
+            source.chromaV = cv::Mat(chromaHeight, chromaWidth, CV_8UC1, vBase, vStride)(half);
+        }
+    } catch (const cv::Exception&) {
+        source = SourceFrame();
+        return VisionError::InvalidInput;
+    }
     return VisionError::None;
 }
 
+VisionError ImagePreprocessor::makeDetectionLevel(const SourceFrame& source, cv::Mat& level) {
+    if (source.empty()) {
+        return VisionError::InvalidInput;
+    }
+    
+    int longEdge = config_.targetLongEdge;
+    if (config_.detectionLongEdge > 0) {
+        longEdge = std::min(longEdge, static_cast<int>(config_.detectionLongEdge));
+    }
+    
+    try {
+        if (source.isLuma()) {
+            cv::Mat chroma;
+            SourceFrame lumaOnly;
+            lumaOnly.luma = source.luma;
+            resizePlanes(lumaOnly, longEdge, level, chroma);
+        } else {
+            resizeAndConvert(source.image, source.toBGR, longEdge, level);
+        }
+    } catch (const cv::Exception&) {
+        return VisionError::OpenCVError;
+    }
+    return VisionError::None;
+}
+
+void ImagePreprocessor::resizePlanes(const SourceFrame& source, int longEdge, cv::Mat& luma, cv::Mat& chroma) {
+    double scale = downscaleFactor(source.luma.cols, source.luma.rows, longEdge);
+    
+    if (scale >= 1.0) {
+        luma = source.luma;
+        if (source.isPlanarChroma()) {
+            cv::Mat planes[2] = { source.chroma, source.chromaV };
+            cv::merge(planes, 2, chromaScratch_);
+            chroma = chromaScratch_;
+        } else {
+            chroma = source.chroma;
+        }
+        return;
+    }
+    
+    cv::Size lumaSize(
+        std::max(2, cvRound(source.luma.cols * scale)) & ~1,
+        std::max(2, cvRound(source.luma.rows * scale)) & ~1
+    );
+    
+    cv::resize(source.luma, lumaBuffer_, lumaSize, 0, 0, cv::INTER_LINEAR);
+    luma = lumaBuffer_;
+    
+    if (source.chroma.empty()) {
+        chroma = cv::Mat();
+    } else if (source.isPlanarChroma()) {
+        cv::Size chromaSize(lumaSize.width / 2, lumaSize.height / 2);
+        cv::resize(source.chroma, chromaPlanes_[0], chromaSize, 0, 0, cv::INTER_LINEAR);
+        cv::resize(source.chromaV, chromaPlanes_[1], chromaSize, 0, 0, cv::INTER_LINEAR);
+        cv::merge(chromaPlanes_, 2, chromaScratch_);
+        chroma = chromaScratch_;
+    } else {
+        cv::Size chromaSize(lumaSize.width / 2, lumaSize.height / 2);
+        cv::resize(source.chroma, chromaScratch_, chromaSize, 0, 0, cv::INTER_LINEAR);
+        chroma = chromaScratch_;
+    }
+}
+
+double ImagePreprocessor::downscaleFactor(int width, int height, int targetLongEdge) const {
+    int longEdge = std::max(width, height);
+    if (longEdge <= targetLongEdge) {
+        return 1.0;
+    }
+    return static_cast<double>(targetLongEdge) / longEdge;
+}
+
+void ImagePreprocessor::resizeAndConvert(const cv::Mat& src, int code, int longEdge, cv::Mat& output) {
+    double scale = downscaleFactor(src.cols, src.rows, longEdge);
+    
+    if (scale >= 1.0) {
+        // 縮小不要: 変換のみ（BGR ならラップしたまま返す）
+        if (code < 0) {
+            output = src;
+        } else {
+            cv::cvtColor(src, ingestBuffer_, code);
+            output = ingestBuffer_;
+        }
+        return;
+    }
+    
+    // 先に縮小してから色変換し、フル解像度の走査を 1 回に抑える
+    if (code < 0) {
+        cv::resize(src, ingestBuffer_, cv::Size(), scale, scale, cv::INTER_LINEAR);
+    } else {
+        cv::resize(src, ingestScratch_, cv::Size(), scale, scale, cv::INTER_LINEAR);
+        cv::cvtColor(ingestScratch_, ingestBuffer_, code);
+    }
+    output = ingestBuffer_;
+}
+
 cv::Mat ImagePreprocessor::resize(const cv::Mat& input) {
-    int longEdge = std::max(input.cols, input.rows);
-    if (longEdge <= config_.targetLongEdge) {
-        return input.clone();
+    cv::Mat buffer;
+    return resize(input, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::resize(const cv::Mat& input, cv::Mat& buffer) {
+    double scale = downscaleFactor(input.cols, input.rows, config_.targetLongEdge);
+    if (scale >= 1.0) {
+        return input;
     }
     
-    double scale = static_cast<double>(config_.targetLongEdge) / longEdge;
-    cv::Mat output;
-    cv::resize(input, output, cv::Size(), scale, scale, cv::INTER_LINEAR);
-    return output;
+    cv::resize(input, buffer, cv::Size(), scale, scale, cv::INTER_LINEAR);
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::toGrayscale(const cv::Mat& input) {
+    cv::Mat buffer;
+    return toGrayscale(input, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::toGrayscale(const cv::Mat& input, cv::Mat& buffer) {
     if (input.channels() == 1) {
-        return input.clone();
+        return input;
     }
     
-    cv::Mat gray;
-    cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-    return gray;
+    cv::cvtColor(input, buffer, cv::COLOR_BGR2GRAY);
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::applyWhiteBalance(const cv::Mat& input) {
-    if (!config_.enableWhiteBalance) {
-        return input.clone();
+    cv::Mat buffer;
+    return applyWhiteBalance(input, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::applyWhiteBalance(const cv::Mat& input, cv::Mat& buffer) {
+    if (!config_.enableWhiteBalance || input.type() != CV_8UC3) {
+        return input;
     }
     
-    cv::Scalar avg = cv::mean(input);
-    double avgGray = (avg[0] + avg[1] + avg[2]) / 3.0;
+    buildWhiteBalanceLUT(estimateChannelMeans(input));
+    cv::LUT(input, whiteBalanceLUT_, buffer);
+    return buffer;
+}
+
+void ImagePreprocessor::applyWhiteBalance(std::vector<cv::Mat>& images) {
+    if (!config_.enableWhiteBalance || images.empty()) {
+        return;
+    }
     
-    std::vector<cv::Mat> channels;
-    cv::split(input, channels);
+    cv::Scalar means;
+    double totalArea = 0.0;
+    for (const cv::Mat& image : images) {
+        if (image.type() != CV_8UC3) return;
+        double area = static_cast<double>(image.total());
+        means += estimateChannelMeans(image) * area;
+        totalArea += area;
+    }
+    if (totalArea <= 0.0) return;
     
-    for (int i = 0; i < 3; ++i) {
-        if (avg[i] > 0) {
-            channels[i].convertTo(channels[i], -1, avgGray / avg[i], 0);
+    buildWhiteBalanceLUT(means * (1.0 / totalArea));
+    for (cv::Mat& image : images) {
+        cv::LUT(image, whiteBalanceLUT_, image);
+    }
+}
+
+cv::Scalar ImagePreprocessor::estimateChannelMeans(const cv::Mat& bgr) const {
+    int step = std::max(1, static_cast<int>(config_.whiteBalanceSampleStep));
+    if (step == 1) {
+        return cv::mean(bgr);
+    }
+    
+    uint64_t sum[3] = { 0, 0, 0 };
+    uint64_t count = 0;
+    for (int y = step / 2; y < bgr.rows; y += step) {
+        const uint8_t* row = bgr.ptr<uint8_t>(y);
+        for (int x = step / 2; x < bgr.cols; x += step) {
+            const uint8_t* px = row + x * 3;
+            sum[0] += px[0];
+            sum[1] += px[1];
+            sum[2] += px[2];
+            ++count;
         }
     }
     
-    cv::Mat output;
-    cv::merge(channels, output);
-    return output;
+    if (count == 0) {
+        return cv::mean(bgr);
+    }
+    return cv::Scalar(
+        static_cast<double>(sum[0]) / count,
+        static_cast<double>(sum[1]) / count,
+        static_cast<double>(sum[2]) / count
+    );
+}
+
+void ImagePreprocessor::buildWhiteBalanceLUT(const cv::Scalar& means) {
+    double avgGray = (means[0] + means[1] + means[2]) / 3.0;
+    double gain[3];
+    for (int c = 0; c < 3; ++c) {
+        gain[c] = means[c] > 0 ? avgGray / means[c] : 1.0;
+    }
+    
+    whiteBalanceLUT_.create(1, 256, CV_8UC3);
+    uint8_t* lut = whiteBalanceLUT_.ptr<uint8_t>(0);
+    for (int v = 0; v < 256; ++v) {
+        for (int c = 0; c < 3; ++c) {
+            lut[v * 3 + c] = cv::saturate_cast<uint8_t>(v * gain[c]);
+        }
+    }
 }
 
 cv::Mat ImagePreprocessor::applyCLAHE(const cv::Mat& gray) {
+    cv::Mat buffer;
+    return applyCLAHE(gray, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::applyCLAHE(const cv::Mat& gray, cv::Mat& buffer) {
+    if (!config_.enableCLAHE || gray.channels() != 1) {
+        return gray;
+    }
+    
+    clahe_->apply(gray, buffer);
+    return buffer;
+}
+
+const cv::Mat& ImagePreprocessor::applyCLAHE(const cv::Mat& gray, double coverageX, double coverageY, cv::Mat& buffer) {
     if (!config_.enableCLAHE || gray.channels() != 1) {
-        return gray.clone();
+        return gray;
     }
     
-    cv::Mat output;
-    clahe_->apply(gray, output);
-    return output;
+    // 元画像でタイルが覆う範囲と同じ範囲を 1 タイルにする
+    auto tiles = [&](double coverage) {
+        return std::max(1, std::min(config_.claheTileSize, cvRound(config_.claheTileSize * coverage)));
+    };
+    regionClahe_->setTilesGridSize(cv::Size(tiles(coverageX), tiles(coverageY)));
+    regionClahe_->apply(gray, buffer);
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::applyGaussianBlur(const cv::Mat& input) {
+    cv::Mat buffer;
+    return applyGaussianBlur(input, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::applyGaussianBlur(const cv::Mat& input, cv::Mat& buffer) {
     if (!config_.enableGaussianBlur) {
-        return input.clone();
+        return input;
     }
     
-    cv::Mat output;
     int ksize = config_.gaussianKernelSize;
     if (ksize % 2 == 0) ksize++;
-    cv::GaussianBlur(input, output, cv::Size(ksize, ksize), 0);
-    return output;
+    cv::GaussianBlur(input, buffer, cv::Size(ksize, ksize), 0);
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::applyBilateralFilter(const cv::Mat& input) {
+    cv::Mat buffer;
+    return applyBilateralFilter(input, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::applyBilateralFilter(const cv::Mat& input, cv::Mat& buffer) {
     if (!config_.enableBilateralFilter) {
-        return input.clone();
+        return input;
     }
     
-    cv::Mat output;
     cv::bilateralFilter(
-        input, output,
+        input, buffer,
         config_.bilateralD,
         config_.bilateralSigmaColor,
         config_.bilateralSigmaSpace
     );
-    return output;
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::adaptiveThreshold(const cv::Mat& gray) {
+    cv::Mat buffer;
+    return adaptiveThreshold(gray, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::adaptiveThreshold(const cv::Mat& gray, cv::Mat& buffer) {
     if (gray.channels() != 1) {
-        return cv::Mat();
+        buffer.release();
+        return buffer;
     }
     
-    cv::Mat binary;
     int blockSize = config_.adaptiveBlockSize;
     if (blockSize % 2 == 0) blockSize++;
     
+    if (config_.adaptiveMethod == AdaptiveThresholdMethod::Integral) {
+        integralThreshold(gray, blockSize, buffer);
+        return buffer;
+    }
+    
     cv::adaptiveThreshold(
-        gray, binary,
+        gray, buffer,
         255,
-        cv::ADAPTIVE_THRESH_GAUSSIAN_C,
+        config_.adaptiveMethod == AdaptiveThresholdMethod::Mean
+            ? cv::ADAPTIVE_THRESH_MEAN_C
+            : cv::ADAPTIVE_THRESH_GAUSSIAN_C,
         cv::THRESH_BINARY,
         blockSize,
         config_.adaptiveC
     );
-    return binary;
+    return buffer;
 }
 
-cv::Mat ImagePreprocessor::morphologyClean(const cv::Mat& binary) {
-    cv::Mat kernel = cv::getStructuringElement(
-        cv::MORPH_RECT,
-        cv::Size(config_.morphKernelSize, config_.morphKernelSize)
-    );
+void ImagePreprocessor::integralThreshold(const cv::Mat& gray, int blockSize, cv::Mat& output) {
+    const int rows = gray.rows;
+    const int cols = gray.cols;
+    // 窓が画像全体と複製した端を覆う大きさで頭打ちにし、パディングの確保量を画像の数倍に抑える
+    blockSize = std::min(blockSize, 2 * std::max(rows, cols) + 1);
+    const int radius = blockSize / 2;
+    // cv::adaptiveThreshold と同じく C は切り上げ、平均は 8 ビットに丸めてから
+    // src - round(sum / area) > -C で判定する。除算を避けるため
+    // (2 (src + C) - 1) * area > 2 sum に変形する（area は奇数なので丸めの同値はない）
+    const int delta = cvCeil(config_.adaptiveC);
+    
+    // 端は cv::adaptiveThreshold と同じ BORDER_REPLICATE で延長し、全画素で窓幅を揃える
+    cv::copyMakeBorder(gray, paddedGray_, radius, radius, radius, radius, cv::BORDER_REPLICATE);
+    
+    // 総和が int に収まらない大きさ（約 8.4 MP 超）では積分画像を倍精度（2^53 まで整数が正確）にする
+    const bool wideSums = 255.0 * static_cast<double>(paddedGray_.total()) > INT_MAX;
+    cv::integral(paddedGray_, integral_, wideSums ? CV_64F : CV_32S);
+    output.create(rows, cols, CV_8UC1);
+    
+    const cv::Mat& sums = integral_;
+    auto body = [&](const cv::Range& range) {
+        if (wideSums) {
+            thresholdRows<double>(gray, sums, blockSize, delta, range, output);
+        } else {
+            thresholdRows<int>(gray, sums, blockSize, delta, range, output);
+        }
+    };
     
-    cv::Mat output;
-    cv::morphologyEx(binary, output, cv::MORPH_CLOSE, kernel);
-    cv::morphologyEx(output, output, cv::MORPH_OPEN, kernel);
-    return output;
+    if (config_.adaptiveThreads == 1) {
+        body(cv::Range(0, rows));
+    } else {
+        double stripes = config_.adaptiveThreads > 1 ? config_.adaptiveThreads : -1.0;
+        cv::parallel_for_(cv::Range(0, rows), body, stripes);
+    }
+}
+
+cv::Mat ImagePreprocessor::morphologyClean(const cv::Mat& binary) {
+    cv::Mat scratch, buffer;
+    return morphologyClean(binary, scratch, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::morphologyClean(const cv::Mat& binary, cv::Mat& scratch, cv::Mat& buffer) {
+    cv::morphologyEx(binary, scratch, cv::MORPH_CLOSE, morphKernel_);
+    cv::morphologyEx(scratch, buffer, cv::MORPH_OPEN, morphKernel_);
+    return buffer;
 }
 
 cv::Mat ImagePreprocessor::detectEdges(const cv::Mat& gray) {
-    cv::Mat edges;
-    cv::Canny(gray, edges, config_.cannyThreshold1, config_.cannyThreshold2);
-    return edges;
+    cv::Mat buffer;
+    return detectEdges(gray, buffer);
+}
+
+const cv::Mat& ImagePreprocessor::detectEdges(const cv::Mat& gray, cv::Mat& buffer) {
+    cv::Canny(gray, buffer, config_.cannyThreshold1, config_.cannyThreshold2);
+    return buffer;
 }
 
 VisionError ImagePreprocessor::preprocess(
@@ -190,23 +627,34 @@ VisionError ImagePreprocessor::preprocess(
     cv::Mat& preprocessed,
     cv::Mat& binary,
     cv::Mat& edges
+) {
+    PreprocessWorkspace workspace;
+    return preprocess(input, workspace, preprocessed, binary, edges);
+}
+
+VisionError ImagePreprocessor::preprocess(
+    const cv::Mat& input,
+    PreprocessWorkspace& ws,
+    cv::Mat& preprocessed,
+    cv::Mat& binary,
+    cv::Mat& edges
 ) {
     if (input.empty()) {
         return VisionError::InvalidInput;
     }
     
     try {
-        cv::Mat resized = resize(input);
-        cv::Mat balanced = applyWhiteBalance(resized);
-        cv::Mat denoised = applyGaussianBlur(balanced);
-        if (config_.enableBilateralFilter) {
-            denoised = applyBilateralFilter(denoised);
-        }
-        cv::Mat gray = toGrayscale(denoised);
-        cv::Mat enhanced = applyCLAHE(gray);
-        cv::Mat binarized = adaptiveThreshold(enhanced);
-        binary = morphologyClean(binarized);
-        edges = detectEdges(enhanced);
+        const cv::Mat& resized = resize(input, ws.resized);
+        // 縮小済みなら作業領域を直接補正し、呼び出し側メモリなら別バッファへ書く
+        const cv::Mat& balanced = applyWhiteBalance(
+            resized, &resized == &ws.resized ? ws.resized : ws.balanced);
+        const cv::Mat& blurred = applyGaussianBlur(balanced, ws.blurred);
+        const cv::Mat& denoised = applyBilateralFilter(blurred, ws.filtered);
+        const cv::Mat& gray = toGrayscale(denoised, ws.gray);
+        const cv::Mat& enhanced = applyCLAHE(gray, ws.enhanced);
+        const cv::Mat& binarized = adaptiveThreshold(enhanced, ws.binarized);
+        binary = morphologyClean(binarized, ws.morphScratch, ws.binary);
+        edges = detectEdges(enhanced, ws.edges);
         preprocessed = denoised;
         
         return VisionError::None;
@@ -215,6 +663,39 @@ VisionError ImagePreprocessor::preprocess(
     }
 }
 
+VisionError ImagePreprocessor::preprocessLuma(
+    const cv::Mat& luma,
+    cv::Mat& binary,
+    cv::Mat& edges
+) {
+    PreprocessWorkspace workspace;
+    return preprocessLuma(luma, workspace, binary, edges);
+}
+
+VisionError ImagePreprocessor::preprocessLuma(
+    const cv::Mat& luma,
+    PreprocessWorkspace& ws,
+    cv::Mat& binary,
+    cv::Mat& edges
+) {
+    if (luma.empty() || luma.channels() != 1) {
+        return VisionError::InvalidInput;
+    }
+    
+    try {
+        const cv::Mat& resized = resize(luma, ws.resized);
+        const cv::Mat& denoised = applyGaussianBlur(resized, ws.blurred);
+        const cv::Mat& enhanced = applyCLAHE(denoised, ws.enhanced);
+        const cv::Mat& binarized = adaptiveThreshold(enhanced, ws.binarized);
+        binary = morphologyClean(binarized, ws.morphScratch, ws.binary);
+        edges = detectEdges(enhanced, ws.edges);
+        
+        return VisionError::None;
+    } catch (const cv::Exception& e) {
+        return VisionError::OpenCVError;
+    }
+}
+
 } // namespace abacus
 
 #else // !ABACUS_HAS_OPENCV
@@ -227,17 +708,45 @@ ImagePreprocessor::ImagePreprocessor(const PreprocessingConfig& config) : config
 ImagePreprocessor::~ImagePreprocessor() = default;
 void ImagePreprocessor::setConfig(const PreprocessingConfig& config) { config_ = config; }
 void ImagePreprocessor::initCLAHE() {}
+double ImagePreprocessor::downscaleFactor(int, int, int) const { return 1.0; }
+void ImagePreprocessor::resizeAndConvert(const cv::Mat& src, int, int, cv::Mat& output) { output = src; }
+void ImagePreprocessor::resizePlanes(const SourceFrame& source, int, cv::Mat& luma, cv::Mat& chroma) {
+    luma = source.luma;
+    chroma = source.isPlanarChroma() ? cv::Mat() : source.chroma;
+}
+VisionError ImagePreprocessor::wrapBuffer(const ImageBuffer&, SourceFrame&) { return VisionError::OpenCVError; }
+VisionError ImagePreprocessor::makeDetectionLevel(const SourceFrame&, cv::Mat&) { return VisionError::OpenCVError; }
 VisionError ImagePreprocessor::convertFromPixelBuffer(const void*, cv::Mat&) { return VisionError::OpenCVError; }
+VisionError ImagePreprocessor::lockPixelBuffer(const void*, ImageBuffer&) { return VisionError::OpenCVError; }
+void ImagePreprocessor::unlockPixelBuffer(const void*) {}
+VisionError ImagePreprocessor::convertFromBuffer(const ImageBuffer&, cv::Mat&) { return VisionError::OpenCVError; }
 cv::Mat ImagePreprocessor::resize(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::resize(const cv::Mat& input, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::toGrayscale(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::toGrayscale(const cv::Mat& input, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::applyWhiteBalance(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::applyWhiteBalance(const cv::Mat& input, cv::Mat&) { return input; }
+void ImagePreprocessor::applyWhiteBalance(std::vector<cv::Mat>&) {}
+cv::Scalar ImagePreprocessor::estimateChannelMeans(const cv::Mat&) const { return cv::Scalar(); }
+void ImagePreprocessor::buildWhiteBalanceLUT(const cv::Scalar&) {}
 cv::Mat ImagePreprocessor::applyCLAHE(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::applyCLAHE(const cv::Mat& input, cv::Mat&) { return input; }
+const cv::Mat& ImagePreprocessor::applyCLAHE(const cv::Mat& input, double, double, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::applyGaussianBlur(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::applyGaussianBlur(const cv::Mat& input, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::applyBilateralFilter(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::applyBilateralFilter(const cv::Mat& input, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::adaptiveThreshold(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::adaptiveThreshold(const cv::Mat& input, cv::Mat&) { return input; }
+void ImagePreprocessor::integralThreshold(const cv::Mat&, int, cv::Mat&) {}
 cv::Mat ImagePreprocessor::morphologyClean(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::morphologyClean(const cv::Mat& input, cv::Mat&, cv::Mat&) { return input; }
 cv::Mat ImagePreprocessor::detectEdges(const cv::Mat& input) { return input; }
+const cv::Mat& ImagePreprocessor::detectEdges(const cv::Mat& input, cv::Mat&) { return input; }
 VisionError ImagePreprocessor::preprocess(const cv::Mat&, cv::Mat&, cv::Mat&, cv::Mat&) { return VisionError::OpenCVError; }
+VisionError ImagePreprocessor::preprocess(const cv::Mat&, PreprocessWorkspace&, cv::Mat&, cv::Mat&, cv::Mat&) { return VisionError::OpenCVError; }
+VisionError ImagePreprocessor::preprocessLuma(const cv::Mat&, cv::Mat&, cv::Mat&) { return VisionError::OpenCVError; }
+VisionError ImagePreprocessor::preprocessLuma(const cv::Mat&, PreprocessWorkspace&, cv::Mat&, cv::Mat&) { return VisionError::OpenCVError; }
 
 } // namespace abacus
 
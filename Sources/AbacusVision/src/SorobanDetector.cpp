@@ -2,12 +2,51 @@
 
 #if ABACUS_HAS_OPENCV
 #include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <numeric>
 
 namespace abacus {
 
+namespace {
+
+/// 上下を含む 3 行から水平 Sobel (3×3) の絶対値を求め、列ごとに加算
+/// cv::Sobel (CV_32F) + cv::convertScaleAbs と同じ値（255 で飽和）を中間画像なしで求める。
+void accumulateGradientRow(const uint8_t* up, const uint8_t* mid, const uint8_t* down, int cols, int* sum) {
+    // 左右端の列は BORDER_REFLECT_101 で両隣が同じ画素になり、常に 0
+    int x = 1;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint16>::vlanes();
+    const int half = cv::VTraits<cv::v_int32>::vlanes();
+    const cv::v_uint16 limit = cv::vx_setall_u16(255);
+    for (; x <= cols - 1 - lanes; x += lanes) {
+        cv::v_int16 d0 = cv::v_sub(
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(up + x + 1)),
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(up + x - 1)));
+        cv::v_int16 d1 = cv::v_sub(
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(mid + x + 1)),
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(mid + x - 1)));
+        cv::v_int16 d2 = cv::v_sub(
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(down + x + 1)),
+            cv::v_reinterpret_as_s16(cv::vx_load_expand(down + x - 1)));
+        cv::v_uint16 magnitude = cv::v_min(cv::v_abs(cv::v_add(cv::v_add(d0, d2), cv::v_add(d1, d1))), limit);
+        
+        cv::v_uint32 lo, hi;
+        cv::v_expand(magnitude, lo, hi);
+        cv::v_store(sum + x, cv::v_add(cv::vx_load(sum + x), cv::v_reinterpret_as_s32(lo)));
+        cv::v_store(sum + x + half, cv::v_add(cv::vx_load(sum + x + half), cv::v_reinterpret_as_s32(hi)));
+    }
+#endif
+    for (; x < cols - 1; ++x) {
+        int d = (up[x + 1] - up[x - 1]) + 2 * (mid[x + 1] - mid[x - 1]) + (down[x + 1] - down[x - 1]);
+        sum[x] += std::min(std::abs(d), 255);
+    }
+}
+
+} // namespace
+
 SorobanDetector::SorobanDetector() : params_() {}
 SorobanDetector::SorobanDetector(const DetectionParams& params) : params_(params) {}
 SorobanDetector::~SorobanDetector() = default;
@@ -34,23 +73,22 @@ FrameDetectionResult SorobanDetector::detectFrame(
     }
     
     double maxArea = 0;
-    std::vector<cv::Point> bestContour;
+    const FrameCandidate* best = nullptr;
     
-    for (const auto& contour : candidates) {
-        double area = cv::contourArea(contour);
-        if (area > maxArea) {
-            maxArea = area;
-            bestContour = contour;
+    for (const auto& candidate : candidates) {
+        if (candidate.area > maxArea) {
+            maxArea = candidate.area;
+            best = &candidate;
         }
     }
     
-    if (bestContour.empty()) {
+    if (!best) {
         return result;
     }
     
-    result.corners = orderCorners(bestContour);
+    result.corners = orderCorners(best->quad);
     
-    cv::Rect rect = cv::boundingRect(bestContour);
+    cv::Rect rect = cv::boundingRect(best->quad);
     result.boundingBox = Rect(
         static_cast<float>(rect.x),
         static_cast<float>(rect.y),
@@ -71,19 +109,166 @@ FrameDetectionResult SorobanDetector::detectFrame(
     return result;
 }
 
-std::vector<std::vector<cv::Point>> SorobanDetector::findFrameCandidates(
+FrameDetectionResult SorobanDetector::trackFrame(
+    const cv::Mat& gray,
+    const FrameDetectionResult& previous
+) {
+    FrameDetectionResult result = previous;
+    result.detected = false;
+    result.confidence = 0.0f;
+    
+    if (!previous.detected || gray.empty() || gray.channels() != 1) {
+        return result;
+    }
+    
+    const Point* quad[4] = {
+        &previous.corners.topLeft, &previous.corners.topRight,
+        &previous.corners.bottomRight, &previous.corners.bottomLeft
+    };
+    
+    const float radius = static_cast<float>(params_.trackingSearchRadius);
+    std::vector<cv::Point2f> corners;
+    corners.reserve(4);
+    for (const Point* pt : quad) {
+        if (pt->x < radius || pt->y < radius ||
+            pt->x >= gray.cols - radius || pt->y >= gray.rows - radius) {
+            return result;
+        }
+        corners.emplace_back(pt->x, pt->y);
+    }
+    
+    cv::cornerSubPix(
+        gray, corners,
+        cv::Size(params_.trackingSearchRadius, params_.trackingSearchRadius),
+        cv::Size(-1, -1),
+        cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 10, 0.05)
+    );
+    
+    // 探索窓を大きく外れた補正は別の特徴に吸着したとみなす
+    for (size_t i = 0; i < corners.size(); ++i) {
+        float dx = corners[i].x - quad[i]->x;
+        float dy = corners[i].y - quad[i]->y;
+        if (dx * dx + dy * dy > 2.0f * radius * radius) {
+            return result;
+        }
+    }
+    
+    Quadrilateral refined;
+    refined.topLeft = Point(corners[0].x, corners[0].y);
+    refined.topRight = Point(corners[1].x, corners[1].y);
+    refined.bottomRight = Point(corners[2].x, corners[2].y);
+    refined.bottomLeft = Point(corners[3].x, corners[3].y);
+    
+    double support = measureEdgeSupport(gray, refined);
+    if (support < params_.trackingMinSupport) {
+        return result;
+    }
+    
+    float minX = std::min({ corners[0].x, corners[1].x, corners[2].x, corners[3].x });
+    float maxX = std::max({ corners[0].x, corners[1].x, corners[2].x, corners[3].x });
+    float minY = std::min({ corners[0].y, corners[1].y, corners[2].y, corners[3].y });
+    float maxY = std::max({ corners[0].y, corners[1].y, corners[2].y, corners[3].y });
+    
+    result.corners = refined;
+    result.boundingBox = Rect(minX, minY, maxX - minX, maxY - minY);
+    result.confidence = static_cast<float>(std::min(previous.confidence, static_cast<float>(support)));
+    result.detected = true;
+    return result;
+}
+
+double SorobanDetector::measureEdgeSupport(const cv::Mat& gray, const Quadrilateral& quad) const {
+    const Point corners[4] = { quad.topLeft, quad.topRight, quad.bottomRight, quad.bottomLeft };
+    const int samplesPerSide = 32;
+    const float offset = 2.0f;
+    
+    int supported = 0;
+    int total = 0;
+    
+    for (int side = 0; side < 4; ++side) {
+        const Point& a = corners[side];
+        const Point& b = corners[(side + 1) % 4];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length < 1.0f) {
+            return 0.0;
+        }
+        float nx = -dy / length;
+        float ny = dx / length;
+        
+        // 隅の近傍は両方の辺の影響を受けるので除外する
+        for (int i = 0; i < samplesPerSide; ++i) {
+            float t = 0.1f + 0.8f * (i + 0.5f) / samplesPerSide;
+            float x = a.x + dx * t;
+            float y = a.y + dy * t;
+            int x0 = cvRound(x - nx * offset);
+            int y0 = cvRound(y - ny * offset);
+            int x1 = cvRound(x + nx * offset);
+            int y1 = cvRound(y + ny * offset);
+            ++total;
+            if (x0 < 0 || y0 < 0 || x1 < 0 || y1 < 0 ||
+                x0 >= gray.cols || x1 >= gray.cols || y0 >= gray.rows || y1 >= gray.rows) {
+                continue;
+            }
+            int diff = std::abs(static_cast<int>(gray.at<uchar>(y1, x1)) - static_cast<int>(gray.at<uchar>(y0, x0)));
+            if (diff >= params_.trackingEdgeThreshold) {
+                ++supported;
+            }
+        }
+    }
+    
+    return total > 0 ? static_cast<double>(supported) / total : 0.0;
+}
+
+std::vector<SorobanDetector::FrameCandidate> SorobanDetector::findFrameCandidates(
     const cv::Mat& binary,
     double imageArea
 ) {
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binary, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    cv::findContours(binary, contours_, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
     
-    std::vector<std::vector<cv::Point>> candidates;
+    std::vector<FrameCandidate> candidates;
     
     double minArea = imageArea * params_.minFrameAreaRatio;
     double maxArea = imageArea * params_.maxFrameAreaRatio;
     
-    for (const auto& contour : contours) {
+    // 点数と外接矩形だけで絞り込む（輪郭の面積は外接矩形の面積を超えない）
+    // 縦横比は近似後の外接矩形で改めて判定するので、ここでは緩めに見る
+    std::vector<std::pair<int, size_t>> shortlist;     // 外接矩形の面積, 輪郭の添字
+    for (size_t i = 0; i < contours_.size(); ++i) {
+        const auto& contour = contours_[i];
+        if (contour.size() < 4) {
+            continue;
+        }
+        
+        cv::Rect bounds = cv::boundingRect(contour);
+        if (bounds.area() < minArea) {
+            continue;
+        }
+        
+        double aspectRatio = static_cast<double>(bounds.width) / bounds.height;
+        if (aspectRatio < params_.minAspectRatio * 0.5 || aspectRatio > params_.maxAspectRatio * 2.0) {
+            continue;
+        }
+        
+        shortlist.emplace_back(bounds.area(), i);
+    }
+    
+    // 大きい順に上限数まで残し、元の輪郭順に戻す
+    size_t limit = static_cast<size_t>(std::max(0, params_.maxFrameContours));
+    if (limit > 0 && shortlist.size() > limit) {
+        std::nth_element(
+            shortlist.begin(), shortlist.begin() + limit, shortlist.end(),
+            [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) { return a.first > b.first; }
+        );
+        shortlist.resize(limit);
+        std::sort(
+            shortlist.begin(), shortlist.end(),
+            [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) { return a.second < b.second; }
+        );
+    }
+    
+    for (const auto& entry : shortlist) {
+        const auto& contour = contours_[entry.second];
         double area = cv::contourArea(contour);
         
         if (area < minArea || area > maxArea) {
@@ -105,7 +290,9 @@ std::vector<std::vector<cv::Point>> SorobanDetector::findFrameCandidates(
             continue;
         }
         
-        candidates.push_back(approx);
+        // detectFrame で比較する近似後の面積をここで求めておく
+        double quadArea = cv::contourArea(approx);
+        candidates.push_back({ std::move(approx), quadArea });
     }
     
     return candidates;
@@ -155,6 +342,174 @@ cv::Mat SorobanDetector::warpFrame(
         return cv::Mat();
     }
     
+    return warpWithCache(original, frame.corners, outputWidth, outputHeight, frameWarp_);
+}
+
+cv::Mat SorobanDetector::warpWithCache(
+    const cv::Mat& original,
+    const Quadrilateral& corners,
+    int outputWidth,
+    int outputHeight,
+    WarpCache& cache
+) {
+    const Point current[4] = { corners.topLeft, corners.topRight, corners.bottomRight, corners.bottomLeft };
+    const Point cached[4] = {
+        cache.corners.topLeft, cache.corners.topRight,
+        cache.corners.bottomRight, cache.corners.bottomLeft
+    };
+    
+    bool reuse = cache.valid &&
+                 cache.sourceSize == original.size() &&
+                 cache.outputSize == cv::Size(outputWidth, outputHeight);
+    for (int i = 0; reuse && i < 4; ++i) {
+        reuse = std::abs(current[i].x - cached[i].x) <= params_.warpCacheTolerance &&
+                std::abs(current[i].y - cached[i].y) <= params_.warpCacheTolerance;
+    }
+    
+    if (!reuse) {
+        std::vector<cv::Point2f> srcPoints = {
+            cv::Point2f(corners.topLeft.x, corners.topLeft.y),
+            cv::Point2f(corners.topRight.x, corners.topRight.y),
+            cv::Point2f(corners.bottomRight.x, corners.bottomRight.y),
+            cv::Point2f(corners.bottomLeft.x, corners.bottomLeft.y)
+        };
+        
+        std::vector<cv::Point2f> dstPoints = {
+            cv::Point2f(0, 0),
+            cv::Point2f(static_cast<float>(outputWidth), 0),
+            cv::Point2f(static_cast<float>(outputWidth), static_cast<float>(outputHeight)),
+            cv::Point2f(0, static_cast<float>(outputHeight))
+        };
+        
+        // 出力画素ごとの参照元座標を逆変換で求め、固定小数点テーブルにする
+        cv::Mat inverse = cv::getPerspectiveTransform(dstPoints, srcPoints);
+        const double* h = inverse.ptr<double>(0);
+        
+        cv::Mat mapXY(outputHeight, outputWidth, CV_32FC2);
+        for (int y = 0; y < outputHeight; ++y) {
+            cv::Vec2f* row = mapXY.ptr<cv::Vec2f>(y);
+            double bx = h[1] * y + h[2];
+            double by = h[4] * y + h[5];
+            double bw = h[7] * y + h[8];
+            for (int x = 0; x < outputWidth; ++x) {
+                double w = h[6] * x + bw;
+                w = w != 0.0 ? 1.0 / w : 0.0;
+                row[x] = cv::Vec2f(
+                    static_cast<float>((h[0] * x + bx) * w),
+                    static_cast<float>((h[3] * x + by) * w)
+                );
+            }
+        }
+        cv::convertMaps(mapXY, cv::noArray(), cache.map1, cache.map2, CV_16SC2);
+        
+        cache.corners = corners;
+        cache.sourceSize = original.size();
+        cache.outputSize = cv::Size(outputWidth, outputHeight);
+        cache.valid = true;
+    }
+    
+    cv::Mat warped;
+    cv::remap(original, warped, cache.map1, cache.map2, cv::INTER_LINEAR);
+    return warped;
+}
+
+cv::Mat SorobanDetector::warpFrame(
+    const cv::Mat& luma,
+    const cv::Mat& chroma,
+    const FrameDetectionResult& frame,
+    int outputWidth,
+    int outputHeight
+) {
+    cv::Mat warpedLuma = warpFrame(luma, frame, outputWidth, outputHeight);
+    if (warpedLuma.empty()) {
+        return cv::Mat();
+    }
+    
+    cv::Mat bgr;
+    if (chroma.empty()) {
+        cv::cvtColor(warpedLuma, bgr, cv::COLOR_GRAY2BGR);
+        return bgr;
+    }
+    
+    // 色差は半解像度なので頂点も半分にして変換する
+    cv::Mat warpedChroma = warpWithCache(
+        chroma,
+        scaleQuadrilateral(frame.corners, 0.5f, 0.5f),
+        outputWidth / 2,
+        outputHeight / 2,
+        chromaWarp_
+    );
+    cv::cvtColorTwoPlane(warpedLuma, warpedChroma, bgr, cv::COLOR_YUV2BGR_NV12);
+    return bgr;
+}
+
+cv::Mat SorobanDetector::warpFrame(
+    const SourceFrame& source,
+    const FrameDetectionResult& frame,
+    int outputWidth,
+    int outputHeight
+) {
+    if (source.isLuma() && !source.isPlanarChroma()) {
+        return warpFrame(source.luma, source.chroma, frame, outputWidth, outputHeight);
+    }
+    
+    if (source.isLuma()) {
+        cv::Mat warpedLuma = warpFrame(source.luma, frame, outputWidth, outputHeight);
+        if (warpedLuma.empty()) {
+            return cv::Mat();
+        }
+        
+        // I420 は U / V を同じ変換テーブルで別々に変換し、出力サイズでのみ UV にまとめる
+        Quadrilateral halfCorners = scaleQuadrilateral(frame.corners, 0.5f, 0.5f);
+        cv::Mat planes[2] = {
+            warpWithCache(source.chroma, halfCorners, outputWidth / 2, outputHeight / 2, chromaWarp_),
+            warpWithCache(source.chromaV, halfCorners, outputWidth / 2, outputHeight / 2, chromaWarp_)
+        };
+        cv::Mat uv, bgr;
+        cv::merge(planes, 2, uv);
+        cv::cvtColorTwoPlane(warpedLuma, uv, bgr, cv::COLOR_YUV2BGR_NV12);
+        return bgr;
+    }
+    
+    // パックド形式は元の形式のまま変換し、色変換は出力サイズでのみ行う
+    cv::Mat warped = warpFrame(source.image, frame, outputWidth, outputHeight);
+    if (warped.empty() || source.toBGR < 0) {
+        return warped;
+    }
+    
+    cv::Mat bgr;
+    cv::cvtColor(warped, bgr, source.toBGR);
+    return bgr;
+}
+
+cv::Mat SorobanDetector::warpLevelFrame(
+    const cv::Mat& level,
+    const FrameDetectionResult& frame,
+    int outputWidth,
+    int outputHeight
+) {
+    if (!frame.detected || level.empty()) {
+        return cv::Mat();
+    }
+    
+    return warpWithCache(level, frame.corners, outputWidth, outputHeight, levelWarp_);
+}
+
+void SorobanDetector::warpCells(
+    const SourceFrame& source,
+    const FrameDetectionResult& frame,
+    int frameWidth,
+    int frameHeight,
+    const std::vector<cv::Rect>& cellRects,
+    int cellSize,
+    std::vector<cv::Mat>& cells
+) {
+    if (!frame.detected || source.empty() || cellRects.empty() || cellSize <= 0) {
+        cells.clear();
+        return;
+    }
+    cells.resize(cellRects.size());
+    
     std::vector<cv::Point2f> srcPoints = {
         cv::Point2f(frame.corners.topLeft.x, frame.corners.topLeft.y),
         cv::Point2f(frame.corners.topRight.x, frame.corners.topRight.y),
@@ -164,55 +519,144 @@ cv::Mat SorobanDetector::warpFrame(
     
     std::vector<cv::Point2f> dstPoints = {
         cv::Point2f(0, 0),
-        cv::Point2f(static_cast<float>(outputWidth), 0),
-        cv::Point2f(static_cast<float>(outputWidth), static_cast<float>(outputHeight)),
-        cv::Point2f(0, static_cast<float>(outputHeight))
+        cv::Point2f(static_cast<float>(frameWidth), 0),
+        cv::Point2f(static_cast<float>(frameWidth), static_cast<float>(frameHeight)),
+        cv::Point2f(0, static_cast<float>(frameHeight))
     };
     
-    cv::Mat M = cv::getPerspectiveTransform(srcPoints, dstPoints);
-    cv::Mat warped;
-    cv::warpPerspective(original, warped, M, cv::Size(outputWidth, outputHeight));
+    // 正規化フレーム座標 → 元画像座標
+    cv::Mat inverse = cv::getPerspectiveTransform(dstPoints, srcPoints);
+    const double* m = inverse.ptr<double>(0);
+    const cv::Size cellDims(cellSize, cellSize);
     
-    return warped;
+    // 4:2:0 の色変換は偶数サイズが必要なので、奇数の cellSize は 1 画素広く変換して切り出す
+    const int evenSize = (cellSize + 1) & ~1;
+    const cv::Size lumaDims(evenSize, evenSize);
+    const cv::Size chromaDims(evenSize / 2, evenSize / 2);
+    
+    for (size_t i = 0; i < cellRects.size(); ++i) {
+        const cv::Rect& rect = cellRects[i];
+        
+        // セル画素 → 正規化フレーム座標（cv::resize と同じ画素中心の対応）
+        double sx = static_cast<double>(rect.width) / cellSize;
+        double sy = static_cast<double>(rect.height) / cellSize;
+        double tx = rect.x + 0.5 * sx - 0.5;
+        double ty = rect.y + 0.5 * sy - 0.5;
+        
+        double h[9] = {
+            m[0] * sx, m[1] * sy, m[0] * tx + m[1] * ty + m[2],
+            m[3] * sx, m[4] * sy, m[3] * tx + m[4] * ty + m[5],
+            m[6] * sx, m[7] * sy, m[6] * tx + m[7] * ty + m[8]
+        };
+        cv::Mat cellTransform(3, 3, CV_64F, h);
+        const int flags = cv::INTER_LINEAR | cv::WARP_INVERSE_MAP;
+        
+        if (!source.isLuma()) {
+            if (source.toBGR < 0) {
+                cv::warpPerspective(source.image, cells[i], cellTransform, cellDims, flags);
+            } else {
+                cv::warpPerspective(source.image, cellScratch_, cellTransform, cellDims, flags);
+                cv::cvtColor(cellScratch_, cells[i], source.toBGR);
+            }
+            continue;
+        }
+        
+        if (source.chroma.empty()) {
+            cv::warpPerspective(source.luma, cellScratch_, cellTransform, cellDims, flags);
+            cv::cvtColor(cellScratch_, cells[i], cv::COLOR_GRAY2BGR);
+            continue;
+        }
+        cv::warpPerspective(source.luma, cellScratch_, cellTransform, lumaDims, flags);
+        
+        // 色差は入出力とも半解像度
+        double hc[9] = {
+            h[0], h[1], 0.5 * h[2],
+            h[3], h[4], 0.5 * h[5],
+            2.0 * h[6], 2.0 * h[7], h[8]
+        };
+        cv::Mat chromaTransform(3, 3, CV_64F, hc);
+        if (source.isPlanarChroma()) {
+            cv::warpPerspective(source.chroma, cellChromaPlanes_[0], chromaTransform, chromaDims, flags);
+            cv::warpPerspective(source.chromaV, cellChromaPlanes_[1], chromaTransform, chromaDims, flags);
+            cv::merge(cellChromaPlanes_, 2, cellChromaScratch_);
+        } else {
+            cv::warpPerspective(source.chroma, cellChromaScratch_, chromaTransform, chromaDims, flags);
+        }
+        if (evenSize == cellSize) {
+            cv::cvtColorTwoPlane(cellScratch_, cellChromaScratch_, cells[i], cv::COLOR_YUV2BGR_NV12);
+        } else {
+            cv::cvtColorTwoPlane(cellScratch_, cellChromaScratch_, cellColorScratch_, cv::COLOR_YUV2BGR_NV12);
+            cellColorScratch_(cv::Rect(0, 0, cellSize, cellSize)).copyTo(cells[i]);
+        }
+    }
 }
 
 int SorobanDetector::detectLaneCount(const cv::Mat& warpedFrame) {
+    std::vector<int> peaks;
+    return detectLaneCount(warpedFrame, peaks);
+}
+
+int SorobanDetector::detectLaneCount(const cv::Mat& warpedFrame, std::vector<int>& peaks) {
+    peaks.clear();
     if (warpedFrame.empty()) return 0;
     
-    cv::Mat gray;
-    if (warpedFrame.channels() == 3) {
-        cv::cvtColor(warpedFrame, gray, cv::COLOR_BGR2GRAY);
-    } else {
-        gray = warpedFrame.clone();
-    }
+    std::vector<int> projection;
+    projectGradient(warpedFrame, projection);
+    
+    RodPitch rods;
+    return countLanes(projection, peaks, rods);
+}
+
+void SorobanDetector::findWindowPeaks(const std::vector<int>& signal, int radius, int threshold, std::vector<int>& peaks) {
+    peaks.clear();
+    const int length = static_cast<int>(signal.size());
+    const int window = 2 * radius + 1;
+    if (radius < 0 || length < window) return;
     
-    cv::Mat sobelX;
-    cv::Sobel(gray, sobelX, CV_32F, 1, 0, 3);
-    cv::Mat absSobelX;
-    cv::convertScaleAbs(sobelX, absSobelX);
+    // 先頭から値が減少する順に添字を保持（同値は残して左端を先頭に保つ）
+    std::vector<int> deque(length);
+    int head = 0;
+    int tail = 0;
     
-    std::vector<int> projection(gray.cols, 0);
-    for (int x = 0; x < gray.cols; ++x) {
-        for (int y = 0; y < gray.rows; ++y) {
-            projection[x] += absSobelX.at<uchar>(y, x);
+    for (int right = 0; right < length; ++right) {
+        while (tail > head && signal[deque[tail - 1]] < signal[right]) {
+            --tail;
+        }
+        deque[tail++] = right;
+        
+        int left = right - window + 1;
+        if (deque[head] < left) {
+            ++head;
+        }
+        if (left < 0) continue;
+        
+        int center = right - radius;
+        if (deque[head] == center && signal[center] > threshold) {
+            peaks.push_back(center);
         }
     }
+}
+
+int SorobanDetector::countLanes(const std::vector<int>& projection, std::vector<int>& peaks, RodPitch& rods) const {
+    peaks.clear();
+    rods = RodPitch();
+    const int cols = static_cast<int>(projection.size());
+    if (cols == 0) return 0;
     
-    std::vector<int> peaks;
-    int windowSize = gray.cols / 50;
-    int threshold = *std::max_element(projection.begin(), projection.end()) / 3;
-    
-    for (int i = windowSize; i < gray.cols - windowSize; ++i) {
-        bool isMax = true;
-        for (int j = i - windowSize; j <= i + windowSize; ++j) {
-            if (j != i && projection[j] >= projection[i]) {
-                isMax = false;
-                break;
-            }
-        }
-        if (isMax && projection[i] > threshold) {
-            peaks.push_back(i);
+    if (params_.enablePitchEstimation) {
+        rods = estimateRodPitch(projection);
+    }
+    
+    if (rods.valid && rods.confidence >= params_.pitchMinConfidence) {
+        // 珠棒の中間を境界とし、両端は画像内に収める
+        for (int i = 0; i <= rods.rodCount; ++i) {
+            double x = rods.firstRod + (i - 0.5) * rods.pitch;
+            peaks.push_back(std::max(0, std::min(cols - 1, static_cast<int>(std::lround(x)))));
         }
+    } else {
+        int windowSize = cols / 50;
+        int threshold = *std::max_element(projection.begin(), projection.end()) / 3;
+        findWindowPeaks(projection, windowSize, threshold, peaks);
     }
     
     int laneCount = static_cast<int>(peaks.size()) - 1;
@@ -221,6 +665,170 @@ int SorobanDetector::detectLaneCount(const cv::Mat& warpedFrame) {
     return laneCount;
 }
 
+void SorobanDetector::projectGradient(const cv::Mat& warpedFrame, std::vector<int>& projection) {
+    cv::Mat converted;
+    const cv::Mat* gray = &warpedFrame;
+    if (warpedFrame.channels() == 3) {
+        cv::cvtColor(warpedFrame, converted, cv::COLOR_BGR2GRAY);
+        gray = &converted;
+    }
+    projectColumns(*gray, 0, gray->rows, projection);
+}
+
+SorobanDetector::RodPitch SorobanDetector::estimateRodPitch(const cv::Mat& warpedFrame) {
+    if (warpedFrame.empty()) return RodPitch();
+    
+    std::vector<int> projection;
+    projectGradient(warpedFrame, projection);
+    return estimateRodPitch(projection);
+}
+
+SorobanDetector::RodPitch SorobanDetector::estimateRodPitch(const std::vector<int>& projection) const {
+    RodPitch result;
+    const int length = static_cast<int>(projection.size());
+    
+    // 周期の探索範囲（最低 2 周期は含まれること）
+    // 枠が幅の一部を占めるので、最短側は maxLaneCount の倍まで余裕を持たせる
+    const int minLag = std::max(2, length / std::max(1, params_.maxLaneCount * 2));
+    const int maxLag = std::min(length / 2, length / std::max(1, params_.minLaneCount));
+    if (minLag + 1 >= maxLag) return result;
+    
+    // 平均を除き、循環の折り返しが起きないよう 2 倍以上に 0 埋めする
+    const int dftLength = cv::getOptimalDFTSize(length * 2);
+    cv::Mat signal = cv::Mat::zeros(1, dftLength, CV_32F);
+    float* values = signal.ptr<float>(0);
+    double mean = std::accumulate(projection.begin(), projection.end(), 0.0) / length;
+    for (int x = 0; x < length; ++x) {
+        values[x] = static_cast<float>(projection[x] - mean);
+    }
+    
+    // 自己相関 = パワースペクトルの逆変換（Wiener–Khinchin）
+    cv::Mat spectrum, power, autocorrelation;
+    cv::dft(signal, spectrum);
+    cv::mulSpectrums(spectrum, spectrum, power, 0, true);
+    cv::dft(power, autocorrelation, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT | cv::DFT_SCALE);
+    
+    const float* ac = autocorrelation.ptr<float>(0);
+    if (ac[0] <= 0.0f) return result;
+    
+    // 重なりの長さで割って偏りを除き、ラグ 0 で正規化する（倍周期の確認用に 2 × maxLag まで）
+    const int lagCount = std::min(length - 1, 2 * maxLag + 3);
+    std::vector<double> normalized(lagCount);
+    for (int lag = 0; lag < lagCount; ++lag) {
+        normalized[lag] = ac[lag] / ac[0] * length / (length - lag);
+    }
+    
+    // 周期的な並びなら 2 倍のラグにも極大がある（珠棒の両縁の間隔のような単発の一致は除く）
+    auto isPeriod = [&](int lag) {
+        if (normalized[lag] < normalized[lag - 1] || normalized[lag] <= normalized[lag + 1]) return false;
+        int harmonic = 2 * lag;
+        if (harmonic + 2 >= lagCount) return true;
+        double support = *std::max_element(normalized.begin() + harmonic - 2, normalized.begin() + harmonic + 3);
+        return support >= normalized[lag] * 0.5;
+    };
+    
+    // 倍周期も同程度の相関を持つので、最大値に近い極大のうち最短のラグを基本周期とする
+    double best = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        if (isPeriod(lag)) {
+            best = std::max(best, normalized[lag]);
+        }
+    }
+    if (best <= 0.0) return result;
+    
+    int period = 0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        if (isPeriod(lag) && normalized[lag] >= best * 0.9) {
+            period = lag;
+            break;
+        }
+    }
+    
+    // 放物線補間で小数精度にする
+    double left = normalized[period - 1];
+    double center = normalized[period];
+    double right = normalized[period + 1];
+    double denominator = left - 2.0 * center + right;
+    double offset = denominator < 0.0 ? 0.5 * (left - right) / denominator : 0.0;
+    result.pitch = period + std::max(-0.5, std::min(0.5, offset));
+    
+    // 推定した周期の成分の位相から、射影が最大になる位置（珠棒の中心）を求める
+    double c = 0.0;
+    double s = 0.0;
+    const double omega = 2.0 * CV_PI / result.pitch;
+    for (int x = 0; x < length; ++x) {
+        double v = projection[x] - mean;
+        c += v * std::cos(omega * x);
+        s += v * std::sin(omega * x);
+    }
+    double phase = std::atan2(s, c) / omega;
+    if (phase < 0.0) phase += result.pitch;
+    
+    result.phase = phase;
+    result.confidence = std::max(0.0, std::min(1.0, center));
+    
+    // 位相は周期内のオフセットなので、枠を除いた珠棒の範囲は別に求める
+    locateRods(projection, result);
+    result.valid = result.rodCount > 0;
+    return result;
+}
+
+void SorobanDetector::locateRods(const std::vector<int>& projection, RodPitch& rods) const {
+    rods.firstRod = 0.0;
+    rods.rodCount = 0;
+    const int length = static_cast<int>(projection.size());
+    if (rods.pitch <= 0.0) return;
+    
+    std::vector<double> support;
+    for (double center = rods.phase; center < length; center += rods.pitch) {
+        int cellBegin = std::max(0, static_cast<int>(std::ceil(center - rods.pitch * 0.5)));
+        int cellEnd = std::min(length, static_cast<int>(std::ceil(center + rods.pitch * 0.5)));
+        int coreBegin = std::max(0, static_cast<int>(std::ceil(center - rods.pitch * 0.25)));
+        int coreEnd = std::min(length, static_cast<int>(std::ceil(center + rods.pitch * 0.25)));
+        
+        double score = 0.0;
+        if (coreEnd > coreBegin) {
+            double sum = std::accumulate(projection.begin() + coreBegin, projection.begin() + coreEnd, 0.0);
+            int base = *std::min_element(projection.begin() + cellBegin, projection.begin() + cellEnd);
+            score = sum / (coreEnd - coreBegin) - base;
+        }
+        support.push_back(score);
+    }
+    if (support.empty()) return;
+    
+    // 珠棒は格子の大半を占めるので、中央値を珠棒 1 本分の支えとみなす
+    std::vector<double> sorted = support;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    const double threshold = sorted[sorted.size() / 2] * 0.5;
+    if (threshold <= 0.0) return;
+    
+    // 支えのある最長の連続区間
+    const int latticeCount = static_cast<int>(support.size());
+    int first = 0;
+    int count = 0;
+    int runStart = 0;
+    for (int i = 0; i <= latticeCount; ++i) {
+        if (i < latticeCount && support[i] >= threshold) continue;
+        if (i - runStart > count) {
+            first = runStart;
+            count = i - runStart;
+        }
+        runStart = i + 1;
+    }
+    
+    // 上限を超える分は支えの弱い端から除く（同じなら一の位を残すため左端から）
+    const int maxCount = std::max(1, params_.maxLaneCount);
+    while (count > maxCount) {
+        if (support[first] <= support[first + count - 1]) {
+            ++first;
+        }
+        --count;
+    }
+    
+    rods.firstRod = rods.phase + first * rods.pitch;
+    rods.rodCount = count;
+}
+
 std::vector<LaneInfo> SorobanDetector::extractLanes(const cv::Mat& warpedFrame, int laneCount) {
     std::vector<LaneInfo> lanes;
     if (warpedFrame.empty() || laneCount <= 0) return lanes;
@@ -244,83 +852,114 @@ std::vector<LaneInfo> SorobanDetector::extractLanes(const cv::Mat& warpedFrame,
     return lanes;
 }
 
-std::vector<cv::Mat> SorobanDetector::extractCells(const cv::Mat& lane, LaneInfo& laneInfo) {
-    std::vector<cv::Mat> cells;
-    if (lane.empty()) return cells;
+std::vector<LaneInfo> SorobanDetector::extractLanes(const cv::Mat& warpedFrame, const RodPitch& rods) {
+    std::vector<LaneInfo> lanes;
+    if (warpedFrame.empty() || !rods.valid || rods.pitch <= 0.0 || rods.rodCount <= 0) return lanes;
     
-    int totalRatio = params_.upperBeadRatio + params_.beadDividerRatio + params_.lowerBeadRatio;
-    int upperHeight = lane.rows * params_.upperBeadRatio / totalRatio;
-    int dividerHeight = lane.rows * params_.beadDividerRatio / totalRatio;
-    int lowerHeight = lane.rows * params_.lowerBeadRatio / totalRatio;
+    const double halfWidth = rods.pitch * std::max(0.0, std::min(1.0, params_.laneCropRatio)) * 0.5;
+    const double cols = warpedFrame.cols;
+    lanes.reserve(rods.rodCount);
     
-    cv::Rect upperRect(0, 0, lane.cols, upperHeight);
-    cells.push_back(lane(upperRect).clone());
+    for (int i = 0; i < rods.rodCount; ++i) {
+        double center = rods.firstRod + i * rods.pitch;
+        double left = std::max(0.0, center - halfWidth);
+        double right = std::min(cols, center + halfWidth);
+        if (right - left < 1.0) continue;
+        
+        LaneInfo lane;
+        lane.boundingBox = Rect(
+            static_cast<float>(std::floor(left)),
+            0,
+            static_cast<float>(std::ceil(right) - std::floor(left)),
+            static_cast<float>(warpedFrame.rows)
+        );
+        lane.value = 0;
+        lane.confidence = 0.0f;
+        lanes.push_back(lane);
+    }
     
-    int lowerStart = upperHeight + dividerHeight;
-    int singleLowerHeight = lowerHeight / 4;
+    // 桁位置は右から数える
+    const int laneCount = static_cast<int>(lanes.size());
+    for (int i = 0; i < laneCount; ++i) {
+        lanes[i].digitIndex = laneCount - 1 - i;
+    }
     
-    for (int i = 0; i < 4; ++i) {
-        cv::Rect lowerRect(0, lowerStart + i * singleLowerHeight, lane.cols, singleLowerHeight);
-        cells.push_back(lane(lowerRect).clone());
+    return lanes;
+}
+
+std::vector<LaneInfo> SorobanDetector::detectLanes(const cv::Mat& warpedFrame) {
+    if (warpedFrame.empty()) return {};
+    
+    std::vector<int> projection;
+    projectGradient(warpedFrame, projection);
+    
+    std::vector<int> peaks;
+    RodPitch rods;
+    int laneCount = countLanes(projection, peaks, rods);
+    
+    if (params_.enableRodCenteredLanes && rods.valid && rods.confidence >= params_.pitchMinConfidence) {
+        std::vector<LaneInfo> lanes = extractLanes(warpedFrame, rods);
+        if (!lanes.empty()) return lanes;
     }
     
+    return extractLanes(warpedFrame, laneCount);
+}
+
+std::vector<cv::Mat> SorobanDetector::extractCells(const cv::Mat& lane, LaneInfo& laneInfo) {
+    std::vector<cv::Mat> cells;
+    cells.reserve(kCellsPerLane);
+    extractCells(lane, laneInfo, cells);
     return cells;
 }
 
-std::vector<int> SorobanDetector::detectLaneBoundaries(const cv::Mat& gray) {
-    std::vector<int> boundaries;
-    if (gray.empty()) return boundaries;
+void SorobanDetector::extractCells(const cv::Mat& lane, LaneInfo& laneInfo, std::vector<cv::Mat>& cells) {
+    if (lane.empty()) return;
     
-    std::vector<int> projection(gray.cols, 0);
-    for (int x = 0; x < gray.cols; ++x) {
-        for (int y = 0; y < gray.rows; ++y) {
-            projection[x] += gray.at<uchar>(y, x);
-        }
+    // ROI ヘッダのみを作る（変換器が読むまで画素には触れない）
+    for (const cv::Rect& rect : computeCellRects(cv::Rect(0, 0, lane.cols, lane.rows))) {
+        cells.emplace_back(lane, rect);
     }
+}
+
+std::vector<cv::Rect> SorobanDetector::computeCellRects(const cv::Rect& lane) const {
+    std::vector<cv::Rect> rects;
+    rects.reserve(kCellsPerLane);
     
-    std::vector<int> smoothed(gray.cols, 0);
-    int smoothWindow = 5;
-    for (int i = smoothWindow; i < gray.cols - smoothWindow; ++i) {
-        int sum = 0;
-        for (int j = -smoothWindow; j <= smoothWindow; ++j) {
-            sum += projection[i + j];
-        }
-        smoothed[i] = sum / (2 * smoothWindow + 1);
-    }
+    int totalRatio = params_.upperBeadRatio + params_.beadDividerRatio + params_.lowerBeadRatio;
+    int upperHeight = lane.height * params_.upperBeadRatio / totalRatio;
+    int dividerHeight = lane.height * params_.beadDividerRatio / totalRatio;
+    int lowerHeight = lane.height * params_.lowerBeadRatio / totalRatio;
     
-    for (int i = 1; i < gray.cols - 1; ++i) {
-        if (smoothed[i] < smoothed[i-1] && smoothed[i] < smoothed[i+1]) {
-            boundaries.push_back(i);
-        }
+    rects.emplace_back(lane.x, lane.y, lane.width, upperHeight);
+    
+    int lowerStart = lane.y + upperHeight + dividerHeight;
+    int singleLowerHeight = lowerHeight / 4;
+    
+    for (int i = 0; i < 4; ++i) {
+        rects.emplace_back(lane.x, lowerStart + i * singleLowerHeight, lane.width, singleLowerHeight);
     }
     
-    return boundaries;
+    return rects;
 }
 
-std::vector<int> SorobanDetector::detectVerticalLines(const cv::Mat& edges) {
-    std::vector<int> linePositions;
-    if (edges.empty()) return linePositions;
+void SorobanDetector::projectColumns(const cv::Mat& gray, int rowBegin, int rowEnd, std::vector<int>& gradient) {
+    const int cols = gray.cols;
+    gradient.assign(cols, 0);
     
-    std::vector<cv::Vec4i> lines;
-    cv::HoughLinesP(edges, lines, params_.houghRho, params_.houghTheta,
-                    params_.houghThreshold, params_.houghMinLength, params_.houghMaxGap);
+    rowBegin = std::max(rowBegin, 0);
+    rowEnd = std::min(rowEnd, gray.rows);
+    if (gray.empty() || gray.type() != CV_8UC1 || rowBegin >= rowEnd) return;
     
-    for (const auto& line : lines) {
-        int x1 = line[0], y1 = line[1], x2 = line[2], y2 = line[3];
-        double angle = std::atan2(std::abs(y2 - y1), std::abs(x2 - x1)) * 180.0 / CV_PI;
-        if (angle > 80.0) {
-            linePositions.push_back((x1 + x2) / 2);
-        }
-    }
-    
-    std::sort(linePositions.begin(), linePositions.end());
-    linePositions.erase(
-        std::unique(linePositions.begin(), linePositions.end(),
-            [](int a, int b) { return std::abs(a - b) < 10; }),
-        linePositions.end()
-    );
+    int* gradientSum = gradient.data();
+    const int lastRow = gray.rows - 1;
     
-    return linePositions;
+    // 行順に走査し、各行の勾配を列ごとの累積に足し込む
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        // 行帯の外の行も近傍として使い、画像端は cv::Sobel と同じく BORDER_REFLECT_101
+        int up = y > 0 ? y - 1 : std::min(1, lastRow);
+        int down = y < lastRow ? y + 1 : std::max(lastRow - 1, 0);
+        accumulateGradientRow(gray.ptr<uint8_t>(up), gray.ptr<uint8_t>(y), gray.ptr<uint8_t>(down), cols, gradientSum);
+    }
 }
 
 } // namespace abacus
@@ -339,7 +978,15 @@ FrameDetectionResult SorobanDetector::detectFrame(const cv::Mat&, const cv::Mat&
     return result;
 }
 
-std::vector<std::vector<cv::Point>> SorobanDetector::findFrameCandidates(const cv::Mat&, double) {
+FrameDetectionResult SorobanDetector::trackFrame(const cv::Mat&, const FrameDetectionResult& previous) {
+    FrameDetectionResult result = previous;
+    result.detected = false;
+    return result;
+}
+
+double SorobanDetector::measureEdgeSupport(const cv::Mat&, const Quadrilateral&) const { return 0.0; }
+
+std::vector<SorobanDetector::FrameCandidate> SorobanDetector::findFrameCandidates(const cv::Mat&, double) {
     return {};
 }
 
@@ -351,15 +998,63 @@ cv::Mat SorobanDetector::warpFrame(const cv::Mat&, const FrameDetectionResult&,
     return cv::Mat();
 }
 
+cv::Mat SorobanDetector::warpWithCache(const cv::Mat&, const Quadrilateral&, int, int, WarpCache&) {
+    return cv::Mat();
+}
+
+cv::Mat SorobanDetector::warpFrame(const cv::Mat&, const cv::Mat&, const FrameDetectionResult&, int, int) {
+    return cv::Mat();
+}
+
+cv::Mat SorobanDetector::warpFrame(const SourceFrame&, const FrameDetectionResult&, int, int) {
+    return cv::Mat();
+}
+
+cv::Mat SorobanDetector::warpLevelFrame(const cv::Mat&, const FrameDetectionResult&, int, int) {
+    return cv::Mat();
+}
+
+void SorobanDetector::warpCells(
+    const SourceFrame&, const FrameDetectionResult&, int, int,
+    const std::vector<cv::Rect>&, int, std::vector<cv::Mat>& cells
+) {
+    cells.clear();
+}
+
+void SorobanDetector::findWindowPeaks(const std::vector<int>&, int, int, std::vector<int>& peaks) {
+    peaks.clear();
+}
+
 int SorobanDetector::detectLaneCount(const cv::Mat&) { return 0; }
 
+int SorobanDetector::detectLaneCount(const cv::Mat&, std::vector<int>& peaks) {
+    peaks.clear();
+    return 0;
+}
+
+int SorobanDetector::countLanes(const std::vector<int>&, std::vector<int>& peaks, RodPitch& rods) const {
+    peaks.clear();
+    rods = RodPitch();
+    return 0;
+}
+
+void SorobanDetector::projectGradient(const cv::Mat&, std::vector<int>& projection) { projection.clear(); }
+SorobanDetector::RodPitch SorobanDetector::estimateRodPitch(const cv::Mat&) { return RodPitch(); }
+SorobanDetector::RodPitch SorobanDetector::estimateRodPitch(const std::vector<int>&) const { return RodPitch(); }
+void SorobanDetector::locateRods(const std::vector<int>&, RodPitch& rods) const { rods.rodCount = 0; }
+
 std::vector<LaneInfo> SorobanDetector::extractLanes(const cv::Mat&, int) { return {}; }
+std::vector<LaneInfo> SorobanDetector::extractLanes(const cv::Mat&, const RodPitch&) { return {}; }
+std::vector<LaneInfo> SorobanDetector::detectLanes(const cv::Mat&) { return {}; }
 
 std::vector<cv::Mat> SorobanDetector::extractCells(const cv::Mat&, LaneInfo&) { return {}; }
+void SorobanDetector::extractCells(const cv::Mat&, LaneInfo&, std::vector<cv::Mat>&) {}
 
-std::vector<int> SorobanDetector::detectLaneBoundaries(const cv::Mat&) { return {}; }
+std::vector<cv::Rect> SorobanDetector::computeCellRects(const cv::Rect&) const { return {}; }
 
-std::vector<int> SorobanDetector::detectVerticalLines(const cv::Mat&) { return {}; }
+void SorobanDetector::projectColumns(const cv::Mat&, int, int, std::vector<int>& gradient) {
+    gradient.clear();
+}
 
 } // namespace abacus
 
@@ -2,39 +2,351 @@
 
 #if ABACUS_HAS_OPENCV
 #include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <utility>
 
 namespace abacus {
 
-TensorConverter::TensorConverter() : config_() {}
-TensorConverter::TensorConverter(const PreprocessingConfig& config) : config_(config) {}
+namespace {
+
+/// 双線形補間の固定小数点精度（cv::resize と同じ 11 ビット）
+constexpr int kInterBits = 11;
+constexpr int kInterOne = 1 << kInterBits;
+
+/// 1 軸分の補間タップ
+struct LinearTap {
+    int i0;
+    int i1;
+    int w1;     // i1 側の重み（kInterOne 単位）
+};
+
+/// 補間用の作業領域
+struct ResizeScratch {
+    std::vector<LinearTap> xTaps;
+    std::vector<LinearTap> yTaps;
+    std::vector<int> rows;
+    std::vector<uint8_t> blended;
+    
+    explicit ResizeScratch(int size)
+        : xTaps(size), yTaps(size), rows(size * 3 * 2), blended(size * 3) {}
+};
+
+/// cv::resize (INTER_LINEAR) と同じ画素中心の対応でタップを計算
+void computeTaps(int srcLength, int dstLength, LinearTap* taps) {
+    double scale = static_cast<double>(srcLength) / dstLength;
+    for (int d = 0; d < dstLength; ++d) {
+        double f = (d + 0.5) * scale - 0.5;
+        int i = cvFloor(f);
+        double t = f - i;
+        if (i < 0) {
+            i = 0;
+            t = 0.0;
+        }
+        if (i >= srcLength - 1) {
+            i = srcLength - 1;
+            t = 0.0;
+        }
+        taps[d] = { i, std::min(i + 1, srcLength - 1), cvRound(t * kInterOne) };
+    }
+}
+
+/// Channels チャンネルの 1 行を水平方向に補間（結果は kInterOne 倍の整数）
+template<int Channels>
+void interpolateRow(const uint8_t* src, const LinearTap* taps, int width, int* dst) {
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* p0 = src + taps[x].i0 * Channels;
+        const uint8_t* p1 = src + taps[x].i1 * Channels;
+        int w1 = taps[x].w1;
+        int w0 = kInterOne - w1;
+        for (int c = 0; c < Channels; ++c) {
+            dst[x * Channels + c] = p0[c] * w0 + p1[c] * w1;
+        }
+    }
+}
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+/// 8 ビット 1 レジスタ分を float 4 レジスタに展開して正規化
+inline void expandNormalized(
+    cv::v_uint8 v, cv::v_float32 scale, cv::v_float32 bias,
+    cv::v_float32& f0, cv::v_float32& f1, cv::v_float32& f2, cv::v_float32& f3
+) {
+    cv::v_uint16 w0, w1;
+    cv::v_expand(v, w0, w1);
+    cv::v_uint32 q0, q1, q2, q3;
+    cv::v_expand(w0, q0, q1);
+    cv::v_expand(w1, q2, q3);
+    f0 = cv::v_muladd(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q0)), scale, bias);
+    f1 = cv::v_muladd(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q1)), scale, bias);
+    f2 = cv::v_muladd(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q2)), scale, bias);
+    f3 = cv::v_muladd(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q3)), scale, bias);
+}
+
+/// 8 ビット 1 レジスタ分を float に展開して正規化し、連続領域に書き込む
+inline void storeNormalized(cv::v_uint8 v, cv::v_float32 scale, cv::v_float32 bias, float* dst) {
+    const int step = cv::VTraits<cv::v_float32>::vlanes();
+    cv::v_float32 f0, f1, f2, f3;
+    expandNormalized(v, scale, bias, f0, f1, f2, f3);
+    cv::v_store(dst, f0);
+    cv::v_store(dst + step, f1);
+    cv::v_store(dst + step * 2, f2);
+    cv::v_store(dst + step * 3, f3);
+}
+#endif
+
+/// インターリーブ BGR 1 行を正規化して R/G/B 平面に書き込む
+/// ベクトル部は LUT と同じ係数の積和で求め（gather より速い）、端数は LUT を引く。
+void normalizeRow(
+    const uint8_t* bgr, int width,
+    const float (*lut)[256], const float* scale, const float* bias,
+    float* r, float* g, float* b
+) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const cv::v_float32 scaleR = cv::vx_setall_f32(scale[0]);
+    const cv::v_float32 scaleG = cv::vx_setall_f32(scale[1]);
+    const cv::v_float32 scaleB = cv::vx_setall_f32(scale[2]);
+    const cv::v_float32 biasR = cv::vx_setall_f32(bias[0]);
+    const cv::v_float32 biasG = cv::vx_setall_f32(bias[1]);
+    const cv::v_float32 biasB = cv::vx_setall_f32(bias[2]);
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 vb, vg, vr;
+        cv::v_load_deinterleave(bgr + x * 3, vb, vg, vr);
+        storeNormalized(vr, scaleR, biasR, r + x);
+        storeNormalized(vg, scaleG, biasG, g + x);
+        storeNormalized(vb, scaleB, biasB, b + x);
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        r[x] = lut[0][px[2]];
+        g[x] = lut[1][px[1]];
+        b[x] = lut[2][px[0]];
+    }
+}
+
+/// インターリーブ BGR 1 行を正規化してインターリーブ RGB (NHWC) で書き込む
+void normalizeRowInterleaved(
+    const uint8_t* bgr, int width,
+    const float (*lut)[256], const float* scale, const float* bias,
+    float* rgb
+) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int step = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 scaleR = cv::vx_setall_f32(scale[0]);
+    const cv::v_float32 scaleG = cv::vx_setall_f32(scale[1]);
+    const cv::v_float32 scaleB = cv::vx_setall_f32(scale[2]);
+    const cv::v_float32 biasR = cv::vx_setall_f32(bias[0]);
+    const cv::v_float32 biasG = cv::vx_setall_f32(bias[1]);
+    const cv::v_float32 biasB = cv::vx_setall_f32(bias[2]);
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 vb, vg, vr;
+        cv::v_load_deinterleave(bgr + x * 3, vb, vg, vr);
+        cv::v_float32 r0, r1, r2, r3, g0, g1, g2, g3, b0, b1, b2, b3;
+        expandNormalized(vr, scaleR, biasR, r0, r1, r2, r3);
+        expandNormalized(vg, scaleG, biasG, g0, g1, g2, g3);
+        expandNormalized(vb, scaleB, biasB, b0, b1, b2, b3);
+        float* dst = rgb + x * 3;
+        cv::v_store_interleave(dst, r0, g0, b0);
+        cv::v_store_interleave(dst + step * 3, r1, g1, b1);
+        cv::v_store_interleave(dst + step * 6, r2, g2, b2);
+        cv::v_store_interleave(dst + step * 9, r3, g3, b3);
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        float* dst = rgb + x * 3;
+        dst[0] = lut[0][px[2]];
+        dst[1] = lut[1][px[1]];
+        dst[2] = lut[2][px[0]];
+    }
+}
+
+/// インターリーブ BGR 1 行を half のインターリーブ RGB (NHWC) で書き込む
+void halfRowInterleaved(const uint8_t* bgr, int width, const uint16_t (*lut)[256], uint16_t* rgb) {
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        uint16_t* dst = rgb + x * 3;
+        dst[0] = lut[0][px[2]];
+        dst[1] = lut[1][px[1]];
+        dst[2] = lut[2][px[0]];
+    }
+}
+
+/// インターリーブ BGR 1 行を 8 ビットのインターリーブ RGB (NHWC) に並べ替え
+void swapRowInterleaved(const uint8_t* bgr, int width, uint8_t* rgb) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 vb, vg, vr;
+        cv::v_load_deinterleave(bgr + x * 3, vb, vg, vr);
+        cv::v_store_interleave(rgb + x * 3, vr, vg, vb);
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        uint8_t* dst = rgb + x * 3;
+        dst[0] = px[2];
+        dst[1] = px[1];
+        dst[2] = px[0];
+    }
+}
+
+/// インターリーブ BGR 1 行を half の R/G/B 平面に書き込む（値は LUT で丸め済み）
+void halfRow(const uint8_t* bgr, int width, const uint16_t (*lut)[256], uint16_t* r, uint16_t* g, uint16_t* b) {
+    for (int x = 0; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        r[x] = lut[0][px[2]];
+        g[x] = lut[1][px[1]];
+        b[x] = lut[2][px[0]];
+    }
+}
+
+/// インターリーブ BGR 1 行を 8 ビットの R/G/B 平面に分解
+void splitRow(const uint8_t* bgr, int width, uint8_t* r, uint8_t* g, uint8_t* b) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 vb, vg, vr;
+        cv::v_load_deinterleave(bgr + x * 3, vb, vg, vr);
+        cv::v_store(r + x, vr);
+        cv::v_store(g + x, vg);
+        cv::v_store(b + x, vb);
+    }
+#endif
+    for (; x < width; ++x) {
+        const uint8_t* px = bgr + x * 3;
+        r[x] = px[2];
+        g[x] = px[1];
+        b[x] = px[0];
+    }
+}
+
+/// 輝度 1 行を正規化して書き込む（1 チャンネルでは NCHW と NHWC は同じ並び）
+void normalizeGrayRow(const uint8_t* gray, int width, const float* lut, float scale, float bias, float* dst) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const cv::v_float32 vscale = cv::vx_setall_f32(scale);
+    const cv::v_float32 vbias = cv::vx_setall_f32(bias);
+    for (; x <= width - lanes; x += lanes) {
+        storeNormalized(cv::vx_load(gray + x), vscale, vbias, dst + x);
+    }
+#endif
+    for (; x < width; ++x) {
+        dst[x] = lut[gray[x]];
+    }
+}
+
+/// 輝度 1 行を half で書き込む
+void halfGrayRow(const uint8_t* gray, int width, const uint16_t* lut, uint16_t* dst) {
+    for (int x = 0; x < width; ++x) {
+        dst[x] = lut[gray[x]];
+    }
+}
+
+} // namespace
+
+uint16_t TensorConverter::toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xffu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffffu;
+    
+    if (((bits >> 23) & 0xffu) == 0xffu && mantissa != 0) {
+        return static_cast<uint16_t>(sign | 0x7e00u);   // NaN は quiet NaN にする
+    }
+    
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    
+    if (exponent <= 0) {
+        // 非正規化数
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t midpoint = 1u << (shift - 1);
+        if (rest > midpoint || (rest == midpoint && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        ++half;     // 桁上がりで指数が増えても正しい値になる
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+TensorConverter::TensorConverter() : config_() {
+    buildNormalizationLUT();
+}
+
+TensorConverter::TensorConverter(const PreprocessingConfig& config) : config_(config) {
+    buildNormalizationLUT();
+}
+
 TensorConverter::~TensorConverter() = default;
 
+void TensorConverter::setConfig(const PreprocessingConfig& config) {
+    bool normalizationChanged =
+        config.meanR != config_.meanR || config.meanG != config_.meanG || config.meanB != config_.meanB ||
+        config.stdR != config_.stdR || config.stdG != config_.stdG || config.stdB != config_.stdB ||
+        config.meanGray != config_.meanGray || config.stdGray != config_.stdGray;
+    config_ = config;
+    if (normalizationChanged) {
+        buildNormalizationLUT();
+    }
+}
+
+void TensorConverter::buildNormalizationLUT() {
+    // (p / 255 - mean) / std = p * scale + bias
+    const float mean[4] = { config_.meanR, config_.meanG, config_.meanB, config_.meanGray };
+    const float std_[4] = { config_.stdR, config_.stdG, config_.stdB, config_.stdGray };
+    for (int c = 0; c < 4; ++c) {
+        normScale_[c] = 1.0f / (255.0f * std_[c]);
+        normBias_[c] = -mean[c] / std_[c];
+        for (int v = 0; v < 256; ++v) {
+            normLUT_[c][v] = v * normScale_[c] + normBias_[c];
+            halfLUT_[c][v] = toHalf(normLUT_[c][v]);
+        }
+    }
+}
+
 VisionError TensorConverter::convertCell(const cv::Mat& cell, CellTensor& tensor) {
     if (cell.empty()) return VisionError::InvalidInput;
     
+    if (cell.type() != CV_8UC3 && cell.type() != CV_8UC1) return VisionError::InvalidInput;
+    
     try {
-        cv::Mat resized;
-        cv::resize(cell, resized, cv::Size(config_.cellOutputSize, config_.cellOutputSize));
-        
-        cv::Mat rgb;
-        if (resized.channels() == 3) {
-            cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
-        } else if (resized.channels() == 1) {
-            cv::cvtColor(resized, rgb, cv::COLOR_GRAY2RGB);
-        } else {
-            return VisionError::InvalidInput;
-        }
-        
-        tensor.channels = 3;
+        tensor.channels = outputChannels();
         tensor.height = config_.cellOutputSize;
         tensor.width = config_.cellOutputSize;
         tensor.data = new float[tensor.size()];
         
         if (!tensor.data) return VisionError::MemoryAllocationFailed;
         
-        normalize(rgb, tensor.data);
-        return VisionError::None;
+        VisionError error = convertToTensor(cell, TensorDataType::Float32, TensorLayout::NCHW, tensor.data);
+        if (error != VisionError::None) {
+            freeTensor(tensor);
+        }
+        return error;
     } catch (...) {
         return VisionError::TensorConversionFailed;
     }
@@ -43,61 +355,253 @@ VisionError TensorConverter::convertCell(const cv::Mat& cell, CellTensor& tensor
 VisionError TensorConverter::convertBatch(const std::vector<cv::Mat>& cells, BatchTensor& batch) {
     if (cells.empty()) return VisionError::InvalidInput;
     
+    // 容量クラスに切り上げてプールから取得する（セル数が少し変わっても同じ領域が再利用される）
+    TensorPool& pool = TensorPool::shared();
+    void* data = nullptr;
+    try {
+        size_t capacity = requiredCapacity(cells.size());
+        data = pool.acquire(capacity * tensorElementSize(config_.tensorDataType));
+        
+        if (!data) return VisionError::MemoryAllocationFailed;
+        
+        VisionError error = convertBatch(cells, data, capacity, batch);
+        if (error != VisionError::None) {
+            pool.release(data);
+            batch.data = nullptr;
+            return error;
+        }
+        
+        batch.ownsData = true;
+        return VisionError::None;
+    } catch (...) {
+        pool.release(data);
+        batch.data = nullptr;
+        return VisionError::TensorConversionFailed;
+    }
+}
+
+VisionError TensorConverter::convertBatch(
+    const std::vector<cv::Mat>& cells,
+    void* destination,
+    size_t capacity,
+    BatchTensor& batch
+) {
+    if (cells.empty() || !destination) return VisionError::InvalidInput;
+    if (capacity < requiredCapacity(cells.size())) return VisionError::MemoryAllocationFailed;
+    
     try {
         batch.batchSize = static_cast<int32_t>(cells.size());
-        batch.channels = 3;
+        batch.channels = outputChannels();
         batch.height = config_.cellOutputSize;
         batch.width = config_.cellOutputSize;
-        batch.data = new float[batch.size()];
-        
-        if (!batch.data) return VisionError::MemoryAllocationFailed;
+        batch.dataType = config_.tensorDataType;
+        batch.layout = config_.tensorLayout;
+        batch.data = destination;
+        batch.ownsData = false;
         
-        size_t cellSize = batch.channels * batch.height * batch.width;
+        size_t cellBytes = batch.channels * batch.height * batch.width * tensorElementSize(batch.dataType);
+        uint8_t* bytes = static_cast<uint8_t*>(destination);
         
-        for (size_t i = 0; i < cells.size(); ++i) {
-            cv::Mat resized;
-            cv::resize(cells[i], resized, cv::Size(config_.cellOutputSize, config_.cellOutputSize));
-            
-            cv::Mat rgb;
-            if (resized.channels() == 3) {
-                cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
-            } else if (resized.channels() == 1) {
-                cv::cvtColor(resized, rgb, cv::COLOR_GRAY2RGB);
-            } else {
-                delete[] batch.data;
-                batch.data = nullptr;
-                return VisionError::InvalidInput;
+        // 各セルは出力の別々の区間に書き込むので、セル単位で分割して並列に変換できる
+        std::atomic<int32_t> failure(static_cast<int32_t>(VisionError::None));
+        auto convertRange = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (failure.load(std::memory_order_relaxed) != 0) return;
+                
+                VisionError error;
+                try {
+                    error = convertToTensor(cells[i], batch.dataType, batch.layout, bytes + i * cellBytes);
+                } catch (...) {
+                    error = VisionError::TensorConversionFailed;
+                }
+                
+                if (error != VisionError::None) {
+                    int32_t expected = 0;
+                    failure.compare_exchange_strong(expected, static_cast<int32_t>(error));
+                    return;
+                }
             }
-            
-            normalize(rgb, batch.data + i * cellSize);
+        };
+        
+        const size_t count = cells.size();
+        const size_t minCells = static_cast<size_t>(std::max(1, config_.parallelMinCells));
+        if (config_.conversionThreads == 1 || count < minCells) {
+            convertRange(0, count);
+        } else if (executor_) {
+            executor_(count, convertRange);
+        } else {
+            double stripes = config_.conversionThreads > 1 ? config_.conversionThreads : -1.0;
+            cv::parallel_for_(cv::Range(0, static_cast<int>(count)), [&](const cv::Range& range) {
+                convertRange(static_cast<size_t>(range.start), static_cast<size_t>(range.end));
+            }, stripes);
         }
         
-        return VisionError::None;
-    } catch (...) {
-        if (batch.data) {
-            delete[] batch.data;
+        if (failure.load() != 0) {
             batch.data = nullptr;
+            return static_cast<VisionError>(failure.load());
         }
+        
+        return VisionError::None;
+    } catch (...) {
+        batch.data = nullptr;
         return VisionError::TensorConversionFailed;
     }
 }
 
-void TensorConverter::normalize(const cv::Mat& input, float* output) {
-    int h = input.rows;
-    int w = input.cols;
+size_t TensorConverter::requiredCapacity(size_t cellCount) const {
+    return cellCount * outputChannels() * static_cast<size_t>(config_.cellOutputSize) * config_.cellOutputSize;
+}
+
+int TensorConverter::outputChannels() const {
+    return config_.tensorChannels == 1 ? 1 : 3;
+}
+
+VisionError TensorConverter::convertToTensor(
+    const cv::Mat& cell,
+    TensorDataType dataType,
+    TensorLayout layout,
+    void* output
+) const {
+    if (cell.empty()) return VisionError::InvalidInput;
+    if (cell.type() != CV_8UC3 && cell.type() != CV_8UC1) return VisionError::InvalidInput;
+    
+    // 出力のチャンネル数に合わせる（通常はセル抽出側で揃っているので変換しない）
+    const int channels = outputChannels();
+    cv::Mat converted;
+    const cv::Mat* source = &cell;
+    if (cell.channels() != channels) {
+        cv::cvtColor(cell, converted, channels == 1 ? cv::COLOR_BGR2GRAY : cv::COLOR_GRAY2BGR);
+        source = &converted;
+    }
+    
+    const int size = config_.cellOutputSize;
+    
+    // 出力サイズでサンプリング済みならチャンネル分解と正規化のみ
+    if (source->cols == size && source->rows == size) {
+        for (int y = 0; y < size; ++y) {
+            writeRow(source->ptr<uint8_t>(y), y, dataType, layout, output);
+        }
+        return VisionError::None;
+    }
+    
+    ResizeScratch scratch(size);
+    const LinearTap* xTaps = scratch.xTaps.data();
+    const LinearTap* yTaps = scratch.yTaps.data();
+    computeTaps(source->cols, size, scratch.xTaps.data());
+    computeTaps(source->rows, size, scratch.yTaps.data());
     
-    float mean[3] = { config_.meanR, config_.meanG, config_.meanB };
-    float std_[3] = { config_.stdR, config_.stdG, config_.stdB };
+    // 水平補間済みの 2 行をキャッシュし、垂直補間した 1 行をそのまま正規化する
+    auto interpolate = channels == 1 ? &interpolateRow<1> : &interpolateRow<3>;
+    const int rowLength = size * channels;
+    int* upper = scratch.rows.data();
+    int* lower = scratch.rows.data() + rowLength;
+    int upperIndex = -1;
+    int lowerIndex = -1;
+    uint8_t* blended = scratch.blended.data();
     
-    for (int c = 0; c < 3; ++c) {
-        for (int y = 0; y < h; ++y) {
-            for (int x = 0; x < w; ++x) {
-                uint8_t pixel = input.at<cv::Vec3b>(y, x)[c];
-                float normalized = (pixel / 255.0f - mean[c]) / std_[c];
-                size_t idx = c * h * w + y * w + x;
-                output[idx] = normalized;
+    const int shift = kInterBits * 2;
+    const int round = 1 << (shift - 1);
+    
+    for (int y = 0; y < size; ++y) {
+        const LinearTap& tap = yTaps[y];
+        if (upperIndex != tap.i0) {
+            if (lowerIndex == tap.i0) {
+                std::swap(upper, lower);
+                std::swap(upperIndex, lowerIndex);
+            } else {
+                interpolate(source->ptr<uint8_t>(tap.i0), xTaps, size, upper);
+                upperIndex = tap.i0;
             }
         }
+        if (lowerIndex != tap.i1) {
+            interpolate(source->ptr<uint8_t>(tap.i1), xTaps, size, lower);
+            lowerIndex = tap.i1;
+        }
+        
+        int w1 = tap.w1;
+        int w0 = kInterOne - w1;
+        for (int k = 0; k < rowLength; ++k) {
+            blended[k] = static_cast<uint8_t>((upper[k] * w0 + lower[k] * w1 + round) >> shift);
+        }
+        
+        writeRow(blended, y, dataType, layout, output);
+    }
+    
+    return VisionError::None;
+}
+
+void TensorConverter::writeRow(
+    const uint8_t* row,
+    int y,
+    TensorDataType dataType,
+    TensorLayout layout,
+    void* output
+) const {
+    const int size = config_.cellOutputSize;
+    
+    if (outputChannels() == 1) {
+        const size_t offset = static_cast<size_t>(y) * size;
+        switch (dataType) {
+            case TensorDataType::Float16:
+                halfGrayRow(row, size, halfLUT_[3], static_cast<uint16_t*>(output) + offset);
+                break;
+            case TensorDataType::UInt8:
+                std::memcpy(static_cast<uint8_t*>(output) + offset, row, size);
+                break;
+            case TensorDataType::Float32:
+            default:
+                normalizeGrayRow(
+                    row, size, normLUT_[3], normScale_[3], normBias_[3],
+                    static_cast<float*>(output) + offset
+                );
+                break;
+        }
+        return;
+    }
+    
+    const uint8_t* bgr = row;
+    
+    if (layout == TensorLayout::NHWC) {
+        // 1 行分が連続するので書き込みは常に前方向の連続アクセスになる
+        const size_t offset = static_cast<size_t>(y) * size * 3;
+        switch (dataType) {
+            case TensorDataType::Float16:
+                halfRowInterleaved(bgr, size, halfLUT_, static_cast<uint16_t*>(output) + offset);
+                break;
+            case TensorDataType::UInt8:
+                swapRowInterleaved(bgr, size, static_cast<uint8_t*>(output) + offset);
+                break;
+            case TensorDataType::Float32:
+            default:
+                normalizeRowInterleaved(
+                    bgr, size, normLUT_, normScale_, normBias_,
+                    static_cast<float*>(output) + offset
+                );
+                break;
+        }
+        return;
+    }
+    
+    const size_t plane = static_cast<size_t>(size) * size;
+    const size_t offset = static_cast<size_t>(y) * size;
+    
+    switch (dataType) {
+        case TensorDataType::Float16: {
+            uint16_t* base = static_cast<uint16_t*>(output) + offset;
+            halfRow(bgr, size, halfLUT_, base, base + plane, base + plane * 2);
+            break;
+        }
+        case TensorDataType::UInt8: {
+            uint8_t* base = static_cast<uint8_t*>(output) + offset;
+            splitRow(bgr, size, base, base + plane, base + plane * 2);
+            break;
+        }
+        case TensorDataType::Float32:
+        default: {
+            float* base = static_cast<float*>(output) + offset;
+            normalizeRow(bgr, size, normLUT_, normScale_, normBias_, base, base + plane, base + plane * 2);
+            break;
+        }
     }
 }
 
@@ -110,7 +614,9 @@ void TensorConverter::freeTensor(CellTensor& tensor) {
 
 void TensorConverter::freeBatch(BatchTensor& batch) {
     if (batch.data) {
-        delete[] batch.data;
+        if (batch.ownsData) {
+            TensorPool::shared().release(batch.data);
+        }
         batch.data = nullptr;
         batch.batchSize = 0;
     }
@@ -126,6 +632,9 @@ TensorConverter::TensorConverter() : config_() {}
 TensorConverter::TensorConverter(const PreprocessingConfig& config) : config_(config) {}
 TensorConverter::~TensorConverter() = default;
 
+void TensorConverter::setConfig(const PreprocessingConfig& config) { config_ = config; }
+void TensorConverter::buildNormalizationLUT() {}
+
 VisionError TensorConverter::convertCell(const cv::Mat&, CellTensor&) {
     return VisionError::OpenCVError;
 }
@@ -134,7 +643,23 @@ VisionError TensorConverter::convertBatch(const std::vector<cv::Mat>&, BatchTens
     return VisionError::OpenCVError;
 }
 
-void TensorConverter::normalize(const cv::Mat&, float*) {}
+VisionError TensorConverter::convertBatch(const std::vector<cv::Mat>&, void*, size_t, BatchTensor&) {
+    return VisionError::OpenCVError;
+}
+
+size_t TensorConverter::requiredCapacity(size_t cellCount) const {
+    return cellCount * outputChannels() * static_cast<size_t>(config_.cellOutputSize) * config_.cellOutputSize;
+}
+
+int TensorConverter::outputChannels() const {
+    return config_.tensorChannels == 1 ? 1 : 3;
+}
+
+uint16_t TensorConverter::toHalf(float) { return 0; }
+
+VisionError TensorConverter::convertToTensor(const cv::Mat&, TensorDataType, TensorLayout, void*) const {
+    return VisionError::OpenCVError;
+}
 
 void TensorConverter::freeTensor(CellTensor& tensor) {
     if (tensor.data) {
@@ -145,7 +670,9 @@ void TensorConverter::freeTensor(CellTensor& tensor) {
 
 void TensorConverter::freeBatch(BatchTensor& batch) {
     if (batch.data) {
-        delete[] batch.data;
+        if (batch.ownsData) {
+            TensorPool::shared().release(batch.data);
+        }
         batch.data = nullptr;
         batch.batchSize = 0;
     }
@@ -0,0 +1,158 @@
+#include "TensorPool.hpp"
+
+#include <cstdlib>
+#include <iterator>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace abacus {
+
+namespace {
+
+/// ヒュージページの大きさ（これ未満の確保には使わない）
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+/// 最小の容量クラス（これ以下の要求はすべてこの大きさで確保する）
+constexpr size_t kMinSizeClass = 4096;
+
+/// 2 のべき乗の間の分割数（切り上げによる余りは最大 1 / kClassSteps）
+constexpr size_t kClassSteps = 4;
+
+} // namespace
+
+TensorPool::TensorPool() = default;
+
+TensorPool::~TensorPool() {
+    // 貸出中のバッファも含めて解放する（破棄後は貸し出したバッファも使えない。shared() は破棄されない）
+    for (const auto& entry : capacities_) {
+        deallocate(entry.first);
+    }
+}
+
+TensorPool& TensorPool::shared() {
+    // 終了処理の後にも結果の解放などで返却されうるので、破棄せずに残す
+    static TensorPool* pool = new TensorPool;
+    return *pool;
+}
+
+size_t TensorPool::sizeClass(size_t bytes) {
+    if (bytes <= kMinSizeClass) return kMinSizeClass;
+    
+    size_t power = kMinSizeClass;
+    while (power <= bytes / 2) power <<= 1;
+    size_t step = power / kClassSteps;
+    return (bytes + step - 1) / step * step;
+}
+
+void* TensorPool::acquire(size_t bytes) {
+    if (bytes == 0) return nullptr;
+    
+    const size_t capacity = sizeClass(bytes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // 直近に返却されたものから探す（キャッシュに残っている可能性が高い）
+    for (auto it = available_.rbegin(); it != available_.rend(); ++it) {
+        if (it->capacity == capacity) {
+            void* data = it->data;
+            retainedBytes_ -= capacity;
+            available_.erase(std::next(it).base());
+            return data;
+        }
+    }
+    
+    void* data = allocate(capacity, useHugePages_);
+    if (data) {
+        capacities_[data] = capacity;
+    }
+    return data;
+}
+
+bool TensorPool::release(void* data) {
+    if (!data) return false;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = capacities_.find(data);
+    if (it == capacities_.end()) {
+        return false;
+    }
+    
+    available_.push_back(IdleBuffer{data, it->second});
+    retainedBytes_ += it->second;
+    evictLocked();
+    return true;
+}
+
+void TensorPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    for (const IdleBuffer& idle : available_) {
+        capacities_.erase(idle.data);
+        deallocate(idle.data);
+    }
+    available_.clear();
+    retainedBytes_ = 0;
+}
+
+void TensorPool::setMaxRetained(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxRetained_ = count;
+    evictLocked();
+}
+
+void TensorPool::setMaxRetainedBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxRetainedBytes_ = bytes;
+    evictLocked();
+}
+
+void TensorPool::evictLocked() {
+    size_t evicted = 0;
+    while (evicted < available_.size() &&
+           (available_.size() - evicted > maxRetained_ || retainedBytes_ > maxRetainedBytes_)) {
+        const IdleBuffer& idle = available_[evicted++];
+        retainedBytes_ -= idle.capacity;
+        capacities_.erase(idle.data);
+        deallocate(idle.data);
+    }
+    available_.erase(available_.begin(), available_.begin() + evicted);
+}
+
+void TensorPool::setUseHugePages(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    useHugePages_ = enabled;
+}
+
+void* TensorPool::allocate(size_t bytes, bool hugePages) {
+    size_t alignment = kAlignment;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (hugePages && bytes >= kHugePageSize) {
+        alignment = kHugePageSize;
+    }
+#else
+    (void)hugePages;
+#endif
+
+    // posix_memalign はサイズの制約がなく、free で解放できる
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignment, bytes) != 0) {
+        return nullptr;
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (alignment == kHugePageSize) {
+        madvise(memory, bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    return memory;
+}
+
+void TensorPool::deallocate(void* data) {
+    std::free(data);
+}
+
+} // namespace abacus
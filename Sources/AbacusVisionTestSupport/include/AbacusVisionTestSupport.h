@@ -0,0 +1,315 @@
+// AbacusVisionTestSupport - Test Hooks
+// テストから C++ 実装を直接呼ぶための C インターフェース（製品には含めない）
+
+#ifndef ABACUS_VISION_TEST_SUPPORT_H
+#define ABACUS_VISION_TEST_SUPPORT_H
+
+#include "AbacusVisionBridge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================
+// Types
+// ============================================================
+
+/// 珠棒の周期推定結果（abacus::SorobanDetector::RodPitch と同じ内容）
+typedef struct {
+    bool valid;
+    double pitch;           // 珠棒の間隔（px）
+    double phase;           // 珠棒の中心位置の周期内オフセット（0 ≤ phase < pitch）
+    double confidence;      // 周期性の強さ (0.0〜1.0)
+    double firstRod;        // 最も左の珠棒の中心位置（px）
+    int32_t rodCount;       // 珠棒の数（枠の部分を除き、maxLaneCount 以下）
+} ABRodPitch;
+
+// ============================================================
+// ImagePreprocessor
+// ============================================================
+
+/// グレースケール画像を前処理と同じ実装で適応的二値化
+/// @param src 入力 (8 ビット)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param method 二値化の方式
+/// @param blockSize 窓の一辺（偶数なら 1 加える）
+/// @param c 平均から引く定数
+/// @param dst 出力 (8 ビット, 0 / 255)
+/// @param dstBytesPerRow 出力の行ストライド（0 なら詰めて配置）
+/// @return エラーコード
+int32_t ab_test_adaptive_threshold(
+    const uint8_t* src,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABAdaptiveThresholdMethod method,
+    int32_t blockSize,
+    double c,
+    uint8_t* dst,
+    size_t dstBytesPerRow
+);
+
+// ============================================================
+// TensorConverter
+// ============================================================
+
+/// Float16 テンソルと同じ変換で float を IEEE 754 binary16 のビット列にする
+/// 最近接偶数丸め、範囲外は ±inf、NaN は quiet NaN。
+/// @param value 変換する値
+/// @return binary16 のビット列
+uint16_t ab_test_float_to_half(float value);
+
+/// セル画像をテンソル変換と同じ実装で呼び出し側のバッファへ変換
+/// @param config 変換設定（テンソル正規化と出力の項目のみ使う）
+/// @param previous 先に適用しておく設定（NULL なら config だけで変換器を作る）。
+///                 config との違いは setConfig で反映される
+/// @param cells 入力（count 枚を詰めて配置、各 width × height × channels の BGR / 輝度）
+/// @param width セルの幅（ピクセル）
+/// @param height セルの高さ（ピクセル）
+/// @param channels セルのチャンネル数（3 または 1）
+/// @param count セル数
+/// @param emptyCell 空の画像に置き換えるセルの番号（負なら置き換えない）
+/// @param output 出力先（要素型・配置は config に従う）
+/// @param capacity output の要素数
+/// @return エラーコード
+int32_t ab_test_convert_cells(
+    const ABVisionConfig* config,
+    const ABVisionConfig* previous,
+    const uint8_t* cells,
+    int32_t width,
+    int32_t height,
+    int32_t channels,
+    int32_t count,
+    int32_t emptyCell,
+    void* output,
+    size_t capacity
+);
+
+/// テンソル変換の参照実装
+/// チャンネル変換、cv::resize (INTER_LINEAR)、RGB への並べ替え、float での正規化を順に行う。
+/// 出力は常に Float32 で、配置・チャンネル数・正規化の係数は config に従う。
+/// @param config 変換設定（tensorDataType は使わない）
+/// @param cells 入力（ab_test_convert_cells と同じ）
+/// @param width セルの幅（ピクセル）
+/// @param height セルの高さ（ピクセル）
+/// @param channels セルのチャンネル数（3 または 1）
+/// @param count セル数
+/// @param output 出力先
+/// @param capacity output の要素数
+/// @return エラーコード
+int32_t ab_test_reference_cells(
+    const ABVisionConfig* config,
+    const uint8_t* cells,
+    int32_t width,
+    int32_t height,
+    int32_t channels,
+    int32_t count,
+    float* output,
+    size_t capacity
+);
+
+// ============================================================
+// TensorPool
+// ============================================================
+
+/// 共有プールとは別の TensorPool を作成（上限は既定値）
+/// @return プールのハンドル（ab_test_pool_destroy で破棄）
+void* ab_test_pool_create(void);
+
+/// プールを破棄（貸出中のバッファも解放される）
+/// @param pool プールのハンドル
+void ab_test_pool_destroy(void* pool);
+
+/// TensorPool::acquire
+/// @param pool プールのハンドル
+/// @param bytes バイト数
+/// @return バッファ（確保失敗時は NULL）
+void* ab_test_pool_acquire(void* pool, size_t bytes);
+
+/// TensorPool::release
+/// @param pool プールのハンドル
+/// @param data 返却するバッファ
+/// @return プールが確保したバッファなら true
+bool ab_test_pool_release(void* pool, void* data);
+
+/// 未使用バッファの上限を設定（超えた分は古いものから解放される）
+/// @param pool プールのハンドル
+/// @param maxRetained 個数の上限
+/// @param maxRetainedBytes 合計バイト数の上限
+void ab_test_pool_set_limits(void* pool, size_t maxRetained, size_t maxRetainedBytes);
+
+/// TensorPool::sizeClass
+/// @param bytes 要求バイト数
+/// @return 切り上げた容量クラス
+size_t ab_test_pool_size_class(size_t bytes);
+
+// ============================================================
+// SorobanDetector
+// ============================================================
+
+/// 二値画像からそろばんフレームを検出（輪郭の絞り込みは本体と同じ）
+/// @param binary 入力 (8 ビット, 0 / 255)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param maxFrameContours 多角形近似まで進める輪郭数の上限（0 で無制限）
+/// @param result 検出結果
+/// @return エラーコード
+int32_t ab_test_detect_frame(
+    const uint8_t* binary,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t maxFrameContours,
+    ABFrameResult* result
+);
+
+/// フレーム検出の参照実装（輪郭の事前絞り込みを入れる前の方法）
+/// すべての輪郭で面積を計算して多角形近似し、4 頂点・凸・縦横比を満たすもののうち
+/// 近似後の面積が最大のものを選ぶ。4 隅は重心に対する象限で順序付ける。
+/// 引数は maxFrameContours を除いて ab_test_detect_frame と同じ。
+int32_t ab_test_reference_detect_frame(
+    const uint8_t* binary,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABFrameResult* result
+);
+
+/// 1 つの検出器で 4 隅を変えながら射影変換する（変換テーブルのキャッシュは呼び出しの間引き継ぐ）
+/// @param image 入力 (8 ビット, 1 チャンネル)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param corners 各回の 4 隅（image 座標系）
+/// @param count 変換の回数
+/// @param tolerance 変換テーブルを再利用する 4 隅の移動量の上限 (warpCacheTolerance)
+/// @param outputWidth 出力幅
+/// @param outputHeight 出力高さ
+/// @param outputs 出力（count 枚を詰めて配置、各 outputWidth × outputHeight）
+/// @return エラーコード
+int32_t ab_test_warp_frames(
+    const uint8_t* image,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    const ABQuadrilateral* corners,
+    int32_t count,
+    float tolerance,
+    int32_t outputWidth,
+    int32_t outputHeight,
+    uint8_t* outputs
+);
+
+/// 単一レーンからセルを抽出し、各セルが参照する画素の位置を返す
+/// セルがレーン画像の ROI（コピーではない）なら、offsets はレーン先頭からのバイト位置になる。
+/// @param lane 入力 (8 ビット BGR)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param rects 各セルの矩形（lane 座標系、capacity 個まで書き込む）
+/// @param offsets 各セルの先頭画素の位置（lane と行ストライドが異なるセルは -1）
+/// @param capacity rects / offsets の要素数
+/// @return 抽出されたセル数（capacity を超えることがある）
+int32_t ab_test_extract_cells(
+    const uint8_t* lane,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABRect* rects,
+    int64_t* offsets,
+    int32_t capacity
+);
+
+/// レーン検出と同じ実装で、行帯の縦方向エッジの列射影を計算
+/// @param gray 入力 (8 ビット, 1 チャンネル)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param rowBegin 行帯の先頭（画像外は切り詰める）
+/// @param rowEnd 行帯の終端
+/// @param projection 出力（width 個）
+/// @return エラーコード
+int32_t ab_test_project_columns(
+    const uint8_t* gray,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t rowBegin,
+    int32_t rowEnd,
+    int32_t* projection
+);
+
+/// 列射影の参照実装
+/// 画像全体に cv::Sobel (dx = 1, 3 × 3) をかけ、cv::convertScaleAbs で 8 ビットにしてから行帯の列ごとに足す。
+/// 引数は ab_test_project_columns と同じ。
+int32_t ab_test_reference_project_columns(
+    const uint8_t* gray,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t rowBegin,
+    int32_t rowEnd,
+    int32_t* projection
+);
+
+/// 正規化フレームからレーン数と境界候補を求める（検出パラメータは既定値）
+/// @param frame 入力 (8 ビット, 1 チャンネル)
+/// @param width 幅（ピクセル）
+/// @param height 高さ（ピクセル）
+/// @param bytesPerRow 入力の行ストライド（0 なら詰めて配置）
+/// @param peaks 境界候補の列位置（昇順、capacity 個まで書き込む）
+/// @param capacity peaks の要素数
+/// @param peakCount 見つかった境界候補の総数（capacity を超えることがある）
+/// @return レーン数（失敗時は 0）
+int32_t ab_test_detect_lane_count(
+    const uint8_t* frame,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t* peaks,
+    int32_t capacity,
+    int32_t* peakCount
+);
+
+/// レーン境界の検出と同じ窓内最大（非最大抑制）でピークを列挙
+/// 窓 [i - radius, i + radius] が系列内に収まり、i がその中で最も左の最大値で、
+/// 値が threshold を超える位置をピークとする。
+/// @param signal 入力系列
+/// @param length 系列の長さ
+/// @param radius 窓の半径
+/// @param threshold これ以下の値は採用しない
+/// @param peaks 出力（昇順、capacity 個まで書き込む）
+/// @param capacity peaks の要素数
+/// @return 見つかったピークの総数（capacity を超えることがある）
+int32_t ab_test_find_peaks(
+    const int32_t* signal,
+    int32_t length,
+    int32_t radius,
+    int32_t threshold,
+    int32_t* peaks,
+    int32_t capacity
+);
+
+/// レーン検出と同じ実装で列射影から珠棒の周期を推定
+/// @param projection 縦方向エッジの列射影
+/// @param length 射影の長さ（正規化フレームの幅）
+/// @param minLaneCount 最小レーン数
+/// @param maxLaneCount 最大レーン数
+/// @param result 推定結果（周期が見つからなければ valid = false）
+/// @return エラーコード
+int32_t ab_test_estimate_rod_pitch(
+    const int32_t* projection,
+    int32_t length,
+    int32_t minLaneCount,
+    int32_t maxLaneCount,
+    ABRodPitch* result
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ABACUS_VISION_TEST_SUPPORT_H
@@ -0,0 +1,753 @@
+// AbacusVisionTestSupport - Test Hooks Implementation
+// 本体の C++ 実装をそのまま呼び出す
+
+#include "AbacusVisionTestSupport.h"
+#include "ImagePreprocessor.hpp"
+#include "SorobanDetector.hpp"
+#include "TensorConverter.hpp"
+#include "TensorPool.hpp"
+#include <algorithm>
+#include <new>
+
+#if ABACUS_HAS_OPENCV
+
+namespace {
+
+/// ABQuadrilateral → abacus::Quadrilateral 変換
+abacus::Quadrilateral toQuadrilateral(const ABQuadrilateral& q) {
+    abacus::Quadrilateral result;
+    result.topLeft = abacus::Point(q.topLeft.x, q.topLeft.y);
+    result.topRight = abacus::Point(q.topRight.x, q.topRight.y);
+    result.bottomRight = abacus::Point(q.bottomRight.x, q.bottomRight.y);
+    result.bottomLeft = abacus::Point(q.bottomLeft.x, q.bottomLeft.y);
+    return result;
+}
+
+/// abacus::FrameDetectionResult → ABFrameResult 変換
+ABFrameResult toFrameResult(const abacus::FrameDetectionResult& f) {
+    ABFrameResult result{};
+    result.detected = f.detected;
+    result.corners.topLeft = ABPoint{ f.corners.topLeft.x, f.corners.topLeft.y };
+    result.corners.topRight = ABPoint{ f.corners.topRight.x, f.corners.topRight.y };
+    result.corners.bottomRight = ABPoint{ f.corners.bottomRight.x, f.corners.bottomRight.y };
+    result.corners.bottomLeft = ABPoint{ f.corners.bottomLeft.x, f.corners.bottomLeft.y };
+    result.boundingBox = ABRect{ f.boundingBox.x, f.boundingBox.y, f.boundingBox.width, f.boundingBox.height };
+    result.confidence = f.confidence;
+    result.laneCount = f.laneCount;
+    return result;
+}
+
+/// 重心に対する象限で 4 隅を順序付け（左上、右上、右下、左下）
+abacus::Quadrilateral orderByQuadrant(const std::vector<cv::Point>& quad) {
+    abacus::Quadrilateral result;
+    float cx = 0.0f;
+    float cy = 0.0f;
+    for (const cv::Point& pt : quad) {
+        cx += pt.x;
+        cy += pt.y;
+    }
+    cx /= 4;
+    cy /= 4;
+    
+    // 各象限の最初の点を使い、象限に点がなければ既定の位置にする
+    abacus::Point corners[4] = {
+        abacus::Point(0, 0), abacus::Point(100, 0), abacus::Point(100, 100), abacus::Point(0, 100)
+    };
+    bool found[4] = { false, false, false, false };
+    for (const cv::Point& pt : quad) {
+        int index;
+        if (pt.x < cx && pt.y < cy) index = 0;
+        else if (pt.x >= cx && pt.y < cy) index = 1;
+        else if (pt.x >= cx && pt.y >= cy) index = 2;
+        else index = 3;
+        if (!found[index]) {
+            corners[index] = abacus::Point(static_cast<float>(pt.x), static_cast<float>(pt.y));
+            found[index] = true;
+        }
+    }
+    
+    result.topLeft = corners[0];
+    result.topRight = corners[1];
+    result.bottomRight = corners[2];
+    result.bottomLeft = corners[3];
+    return result;
+}
+
+/// ABVisionConfig のテンソル変換の項目を abacus::PreprocessingConfig に写す
+abacus::PreprocessingConfig toTensorConfig(const ABVisionConfig& c) {
+    abacus::PreprocessingConfig result;
+    result.meanR = c.mean[0];
+    result.meanG = c.mean[1];
+    result.meanB = c.mean[2];
+    result.stdR = c.std[0];
+    result.stdG = c.std[1];
+    result.stdB = c.std[2];
+    result.meanGray = c.meanGray;
+    result.stdGray = c.stdGray;
+    result.cellOutputSize = c.cellOutputSize;
+    result.tensorDataType = static_cast<abacus::TensorDataType>(c.tensorDataType);
+    result.tensorLayout = static_cast<abacus::TensorLayout>(c.tensorLayout);
+    result.tensorChannels = c.tensorChannels;
+    result.conversionThreads = c.conversionThreads;
+    result.parallelMinCells = c.parallelMinCells;
+    return result;
+}
+
+/// 詰めて配置したセル列の i 番目を参照する Mat
+cv::Mat cellAt(const uint8_t* cells, int32_t width, int32_t height, int32_t channels, int32_t i) {
+    const size_t cellBytes = static_cast<size_t>(width) * height * channels;
+    return cv::Mat(height, width, channels == 1 ? CV_8UC1 : CV_8UC3, const_cast<uint8_t*>(cells + i * cellBytes));
+}
+
+} // namespace
+
+extern "C" {
+
+int32_t ab_test_adaptive_threshold(
+    const uint8_t* src,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABAdaptiveThresholdMethod method,
+    int32_t blockSize,
+    double c,
+    uint8_t* dst,
+    size_t dstBytesPerRow
+) {
+    if (!src || !dst || width <= 0 || height <= 0 || blockSize < 3) {
+        return ABVisionErrorInvalidInput;
+    }
+    if ((bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) ||
+        (dstBytesPerRow != 0 && dstBytesPerRow < static_cast<size_t>(width))) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    try {
+        abacus::PreprocessingConfig config;
+        config.adaptiveMethod = static_cast<abacus::AdaptiveThresholdMethod>(method);
+        config.adaptiveBlockSize = blockSize;
+        config.adaptiveC = c;
+        abacus::ImagePreprocessor preprocessor(config);
+        
+        cv::Mat gray(height, width, CV_8UC1, const_cast<uint8_t*>(src), bytesPerRow);
+        cv::Mat output(height, width, CV_8UC1, dst, dstBytesPerRow);
+        cv::Mat binary;
+        preprocessor.adaptiveThreshold(gray, binary).copyTo(output);
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+uint16_t ab_test_float_to_half(float value) {
+    return abacus::TensorConverter::toHalf(value);
+}
+
+int32_t ab_test_convert_cells(
+    const ABVisionConfig* config,
+    const ABVisionConfig* previous,
+    const uint8_t* cells,
+    int32_t width,
+    int32_t height,
+    int32_t channels,
+    int32_t count,
+    int32_t emptyCell,
+    void* output,
+    size_t capacity
+) {
+    if (!config || !cells || width <= 0 || height <= 0 || count <= 0 || (channels != 1 && channels != 3)) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    try {
+        abacus::TensorConverter converter(toTensorConfig(previous ? *previous : *config));
+        if (previous) {
+            converter.setConfig(toTensorConfig(*config));
+        }
+        
+        std::vector<cv::Mat> images(count);
+        for (int32_t i = 0; i < count; ++i) {
+            if (i != emptyCell) {
+                images[i] = cellAt(cells, width, height, channels, i);
+            }
+        }
+        
+        abacus::BatchTensor batch;
+        return static_cast<int32_t>(converter.convertBatch(images, output, capacity, batch));
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_reference_cells(
+    const ABVisionConfig* config,
+    const uint8_t* cells,
+    int32_t width,
+    int32_t height,
+    int32_t channels,
+    int32_t count,
+    float* output,
+    size_t capacity
+) {
+    if (!config || !cells || !output || width <= 0 || height <= 0 || count <= 0 ||
+        (channels != 1 && channels != 3) || config->cellOutputSize <= 0) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    const int size = config->cellOutputSize;
+    const int outputChannels = config->tensorChannels == 1 ? 1 : 3;
+    const size_t cellElements = static_cast<size_t>(outputChannels) * size * size;
+    if (capacity < cellElements * count) return ABVisionErrorMemoryAllocationFailed;
+    
+    // 出力の c 番目の平均・標準偏差（R, G, B または輝度）
+    const float mean[3] = {
+        outputChannels == 1 ? config->meanGray : config->mean[0], config->mean[1], config->mean[2]
+    };
+    const float std_[3] = {
+        outputChannels == 1 ? config->stdGray : config->std[0], config->std[1], config->std[2]
+    };
+    const bool interleaved = config->tensorLayout == ABTensorLayoutNHWC;
+    
+    try {
+        for (int32_t i = 0; i < count; ++i) {
+            cv::Mat cell = cellAt(cells, width, height, channels, i);
+            cv::Mat converted = cell;
+            if (channels != outputChannels) {
+                cv::cvtColor(cell, converted, outputChannels == 1 ? cv::COLOR_BGR2GRAY : cv::COLOR_GRAY2BGR);
+            }
+            cv::Mat resized;
+            cv::resize(converted, resized, cv::Size(size, size), 0, 0, cv::INTER_LINEAR);
+            
+            float* dst = output + i * cellElements;
+            for (int y = 0; y < size; ++y) {
+                const uint8_t* row = resized.ptr<uint8_t>(y);
+                for (int x = 0; x < size; ++x) {
+                    for (int c = 0; c < outputChannels; ++c) {
+                        // BGR の並びを逆順にして R, G, B とする
+                        uint8_t value = row[x * outputChannels + (outputChannels == 1 ? 0 : 2 - c)];
+                        size_t index = interleaved
+                            ? (static_cast<size_t>(y) * size + x) * outputChannels + c
+                            : (static_cast<size_t>(c) * size + y) * size + x;
+                        dst[index] = (value / 255.0f - mean[c]) / std_[c];
+                    }
+                }
+            }
+        }
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_detect_frame(
+    const uint8_t* binary,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t maxFrameContours,
+    ABFrameResult* result
+) {
+    if (!result) return ABVisionErrorInvalidInput;
+    *result = ABFrameResult{};
+    if (!binary || width <= 0 || height <= 0 || maxFrameContours < 0) return ABVisionErrorInvalidInput;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) return ABVisionErrorInvalidInput;
+    
+    try {
+        abacus::SorobanDetector::DetectionParams params;
+        params.maxFrameContours = maxFrameContours;
+        abacus::SorobanDetector detector(params);
+        
+        cv::Mat image(height, width, CV_8UC1, const_cast<uint8_t*>(binary), bytesPerRow);
+        *result = toFrameResult(detector.detectFrame(image, image, cv::Mat()));
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_reference_detect_frame(
+    const uint8_t* binary,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABFrameResult* result
+) {
+    if (!result) return ABVisionErrorInvalidInput;
+    *result = ABFrameResult{};
+    if (!binary || width <= 0 || height <= 0) return ABVisionErrorInvalidInput;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) return ABVisionErrorInvalidInput;
+    
+    try {
+        const abacus::SorobanDetector::DetectionParams params;
+        cv::Mat image(height, width, CV_8UC1, const_cast<uint8_t*>(binary), bytesPerRow);
+        std::vector<std::vector<cv::Point>> contours;
+        cv::findContours(image, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        
+        const double imageArea = static_cast<double>(width) * height;
+        const double minArea = imageArea * params.minFrameAreaRatio;
+        const double maxArea = imageArea * params.maxFrameAreaRatio;
+        
+        double bestArea = 0.0;
+        std::vector<cv::Point> best;
+        for (const auto& contour : contours) {
+            double area = cv::contourArea(contour);
+            if (area < minArea || area > maxArea) continue;
+            
+            std::vector<cv::Point> approx;
+            cv::approxPolyDP(contour, approx, params.contourApproxEpsilon * cv::arcLength(contour, true), true);
+            if (approx.size() != 4 || !cv::isContourConvex(approx)) continue;
+            
+            cv::Rect rect = cv::boundingRect(approx);
+            double aspectRatio = static_cast<double>(rect.width) / rect.height;
+            if (aspectRatio < params.minAspectRatio || aspectRatio > params.maxAspectRatio) continue;
+            
+            double quadArea = cv::contourArea(approx);
+            if (quadArea > bestArea) {
+                bestArea = quadArea;
+                best = approx;
+            }
+        }
+        if (best.empty()) return ABVisionErrorNone;
+        
+        abacus::FrameDetectionResult frame{};
+        frame.detected = true;
+        frame.corners = orderByQuadrant(best);
+        cv::Rect rect = cv::boundingRect(best);
+        frame.boundingBox = abacus::Rect(
+            static_cast<float>(rect.x), static_cast<float>(rect.y),
+            static_cast<float>(rect.width), static_cast<float>(rect.height)
+        );
+        double areaRatio = bestArea / imageArea;
+        double aspectRatio = static_cast<double>(rect.width) / rect.height;
+        frame.confidence = aspectRatio >= params.minAspectRatio && aspectRatio <= params.maxAspectRatio
+            ? static_cast<float>(std::min(1.0, areaRatio * 5.0))
+            : static_cast<float>(areaRatio * 0.5);
+        *result = toFrameResult(frame);
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_warp_frames(
+    const uint8_t* image,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    const ABQuadrilateral* corners,
+    int32_t count,
+    float tolerance,
+    int32_t outputWidth,
+    int32_t outputHeight,
+    uint8_t* outputs
+) {
+    if (!image || !corners || !outputs || width <= 0 || height <= 0 || count <= 0 ||
+        outputWidth <= 0 || outputHeight <= 0 || tolerance < 0.0f) {
+        return ABVisionErrorInvalidInput;
+    }
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    try {
+        abacus::SorobanDetector::DetectionParams params;
+        params.warpCacheTolerance = tolerance;
+        abacus::SorobanDetector detector(params);
+        
+        cv::Mat gray(height, width, CV_8UC1, const_cast<uint8_t*>(image), bytesPerRow);
+        const size_t outputSize = static_cast<size_t>(outputWidth) * outputHeight;
+        
+        for (int32_t i = 0; i < count; ++i) {
+            abacus::FrameDetectionResult frame{};
+            frame.detected = true;
+            frame.corners = toQuadrilateral(corners[i]);
+            
+            cv::Mat warped = detector.warpFrame(gray, frame, outputWidth, outputHeight);
+            if (warped.empty()) return ABVisionErrorLaneExtractionFailed;
+            cv::Mat output(outputHeight, outputWidth, CV_8UC1, outputs + i * outputSize);
+            warped.copyTo(output);
+        }
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_extract_cells(
+    const uint8_t* lane,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    ABRect* rects,
+    int64_t* offsets,
+    int32_t capacity
+) {
+    if (!lane || width <= 0 || height <= 0) return 0;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width) * 3) return 0;
+    
+    try {
+        abacus::SorobanDetector detector;
+        cv::Mat image(height, width, CV_8UC3, const_cast<uint8_t*>(lane), bytesPerRow);
+        abacus::LaneInfo laneInfo{};
+        std::vector<cv::Mat> cells = detector.extractCells(image, laneInfo);
+        std::vector<cv::Rect> cellRects = detector.computeCellRects(cv::Rect(0, 0, width, height));
+        
+        int32_t count = static_cast<int32_t>(cells.size());
+        for (int32_t i = 0; i < std::min(count, capacity); ++i) {
+            if (rects && i < static_cast<int32_t>(cellRects.size())) {
+                const cv::Rect& r = cellRects[i];
+                rects[i] = ABRect{
+                    static_cast<float>(r.x), static_cast<float>(r.y),
+                    static_cast<float>(r.width), static_cast<float>(r.height)
+                };
+            }
+            if (offsets) {
+                offsets[i] = cells[i].step[0] == image.step[0]
+                    ? static_cast<int64_t>(cells[i].data - image.data)
+                    : -1;
+            }
+        }
+        return count;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int32_t ab_test_project_columns(
+    const uint8_t* gray,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t rowBegin,
+    int32_t rowEnd,
+    int32_t* projection
+) {
+    if (!gray || !projection || width <= 0 || height <= 0) return ABVisionErrorInvalidInput;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) return ABVisionErrorInvalidInput;
+    
+    try {
+        cv::Mat image(height, width, CV_8UC1, const_cast<uint8_t*>(gray), bytesPerRow);
+        std::vector<int> columns;
+        abacus::SorobanDetector::projectColumns(image, rowBegin, rowEnd, columns);
+        std::copy(columns.begin(), columns.end(), projection);
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_reference_project_columns(
+    const uint8_t* gray,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t rowBegin,
+    int32_t rowEnd,
+    int32_t* projection
+) {
+    if (!gray || !projection || width <= 0 || height <= 0) return ABVisionErrorInvalidInput;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) return ABVisionErrorInvalidInput;
+    
+    try {
+        cv::Mat image(height, width, CV_8UC1, const_cast<uint8_t*>(gray), bytesPerRow);
+        cv::Mat gradient, magnitude;
+        cv::Sobel(image, gradient, CV_32F, 1, 0, 3);
+        cv::convertScaleAbs(gradient, magnitude);
+        
+        std::fill(projection, projection + width, 0);
+        for (int y = std::max(rowBegin, 0); y < std::min(rowEnd, height); ++y) {
+            const uint8_t* row = magnitude.ptr<uint8_t>(y);
+            for (int x = 0; x < width; ++x) {
+                projection[x] += row[x];
+            }
+        }
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+int32_t ab_test_detect_lane_count(
+    const uint8_t* frame,
+    int32_t width,
+    int32_t height,
+    size_t bytesPerRow,
+    int32_t* peaks,
+    int32_t capacity,
+    int32_t* peakCount
+) {
+    if (peakCount) *peakCount = 0;
+    if (!frame || width <= 0 || height <= 0) return 0;
+    if (bytesPerRow != 0 && bytesPerRow < static_cast<size_t>(width)) return 0;
+    
+    try {
+        abacus::SorobanDetector detector;
+        cv::Mat image(height, width, CV_8UC1, const_cast<uint8_t*>(frame), bytesPerRow);
+        std::vector<int> found;
+        int laneCount = detector.detectLaneCount(image, found);
+        
+        int32_t count = static_cast<int32_t>(found.size());
+        if (peaks) {
+            std::copy_n(found.begin(), std::min(count, std::max(capacity, 0)), peaks);
+        }
+        if (peakCount) *peakCount = count;
+        return laneCount;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int32_t ab_test_find_peaks(
+    const int32_t* signal,
+    int32_t length,
+    int32_t radius,
+    int32_t threshold,
+    int32_t* peaks,
+    int32_t capacity
+) {
+    if (!signal || length <= 0) return 0;
+    
+    std::vector<int> input(signal, signal + length);
+    std::vector<int> found;
+    abacus::SorobanDetector::findWindowPeaks(input, radius, threshold, found);
+    
+    int32_t count = static_cast<int32_t>(found.size());
+    if (peaks) {
+        std::copy_n(found.begin(), std::min(count, std::max(capacity, 0)), peaks);
+    }
+    return count;
+}
+
+int32_t ab_test_estimate_rod_pitch(
+    const int32_t* projection,
+    int32_t length,
+    int32_t minLaneCount,
+    int32_t maxLaneCount,
+    ABRodPitch* result
+) {
+    if (!result) return ABVisionErrorInvalidInput;
+    *result = ABRodPitch{};
+    if (!projection || length <= 0 || minLaneCount <= 0 || maxLaneCount < minLaneCount) {
+        return ABVisionErrorInvalidInput;
+    }
+    
+    try {
+        abacus::SorobanDetector::DetectionParams params;
+        params.minLaneCount = minLaneCount;
+        params.maxLaneCount = maxLaneCount;
+        abacus::SorobanDetector detector(params);
+        
+        std::vector<int> input(projection, projection + length);
+        abacus::SorobanDetector::RodPitch rods = detector.estimateRodPitch(input);
+        
+        result->valid = rods.valid;
+        result->pitch = rods.pitch;
+        result->phase = rods.phase;
+        result->confidence = rods.confidence;
+        result->firstRod = rods.firstRod;
+        result->rodCount = rods.rodCount;
+        return ABVisionErrorNone;
+    } catch (...) {
+        return ABVisionErrorOpenCVError;
+    }
+}
+
+} // extern "C"
+
+#else // !ABACUS_HAS_OPENCV
+
+// Stub implementation when OpenCV is not available
+extern "C" {
+
+int32_t ab_test_adaptive_threshold(
+    const uint8_t* /* src */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    ABAdaptiveThresholdMethod /* method */,
+    int32_t /* blockSize */,
+    double /* c */,
+    uint8_t* /* dst */,
+    size_t /* dstBytesPerRow */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+uint16_t ab_test_float_to_half(float /* value */) {
+    return 0;
+}
+
+int32_t ab_test_convert_cells(
+    const ABVisionConfig* /* config */,
+    const ABVisionConfig* /* previous */,
+    const uint8_t* /* cells */,
+    int32_t /* width */,
+    int32_t /* height */,
+    int32_t /* channels */,
+    int32_t /* count */,
+    int32_t /* emptyCell */,
+    void* /* output */,
+    size_t /* capacity */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_reference_cells(
+    const ABVisionConfig* /* config */,
+    const uint8_t* /* cells */,
+    int32_t /* width */,
+    int32_t /* height */,
+    int32_t /* channels */,
+    int32_t /* count */,
+    float* /* output */,
+    size_t /* capacity */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_detect_frame(
+    const uint8_t* /* binary */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    int32_t /* maxFrameContours */,
+    ABFrameResult* result
+) {
+    if (result) *result = ABFrameResult{};
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_reference_detect_frame(
+    const uint8_t* /* binary */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    ABFrameResult* result
+) {
+    if (result) *result = ABFrameResult{};
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_warp_frames(
+    const uint8_t* /* image */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    const ABQuadrilateral* /* corners */,
+    int32_t /* count */,
+    float /* tolerance */,
+    int32_t /* outputWidth */,
+    int32_t /* outputHeight */,
+    uint8_t* /* outputs */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_extract_cells(
+    const uint8_t* /* lane */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    ABRect* /* rects */,
+    int64_t* /* offsets */,
+    int32_t /* capacity */
+) {
+    return 0;
+}
+
+int32_t ab_test_project_columns(
+    const uint8_t* /* gray */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    int32_t /* rowBegin */,
+    int32_t /* rowEnd */,
+    int32_t* /* projection */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_reference_project_columns(
+    const uint8_t* /* gray */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    int32_t /* rowBegin */,
+    int32_t /* rowEnd */,
+    int32_t* /* projection */
+) {
+    return ABVisionErrorOpenCVError;
+}
+
+int32_t ab_test_detect_lane_count(
+    const uint8_t* /* frame */,
+    int32_t /* width */,
+    int32_t /* height */,
+    size_t /* bytesPerRow */,
+    int32_t* /* peaks */,
+    int32_t /* capacity */,
+    int32_t* peakCount
+) {
+    if (peakCount) *peakCount = 0;
+    return 0;
+}
+
+int32_t ab_test_find_peaks(
+    const int32_t* /* signal */,
+    int32_t /* length */,
+    int32_t /* radius */,
+    int32_t /* threshold */,
+    int32_t* /* peaks */,
+    int32_t /* capacity */
+) {
+    return 0;
+}
+
+int32_t ab_test_estimate_rod_pitch(
+    const int32_t* /* projection */,
+    int32_t /* length */,
+    int32_t /* minLaneCount */,
+    int32_t /* maxLaneCount */,
+    ABRodPitch* result
+) {
+    if (result) *result = ABRodPitch{};
+    return ABVisionErrorOpenCVError;
+}
+
+} // extern "C"
+
+#endif // ABACUS_HAS_OPENCV
+
+// TensorPool は OpenCV に依存しないので、どちらの構成でも本体を呼ぶ
+extern "C" {
+
+void* ab_test_pool_create(void) {
+    return new (std::nothrow) abacus::TensorPool;
+}
+
+void ab_test_pool_destroy(void* pool) {
+    delete static_cast<abacus::TensorPool*>(pool);
+}
+
+void* ab_test_pool_acquire(void* pool, size_t bytes) {
+    if (!pool) return nullptr;
+    return static_cast<abacus::TensorPool*>(pool)->acquire(bytes);
+}
+
+bool ab_test_pool_release(void* pool, void* data) {
+    if (!pool) return false;
+    return static_cast<abacus::TensorPool*>(pool)->release(data);
+}
+
+void ab_test_pool_set_limits(void* pool, size_t maxRetained, size_t maxRetainedBytes) {
+    if (!pool) return;
+    auto* tensorPool = static_cast<abacus::TensorPool*>(pool);
+    tensorPool->setMaxRetained(maxRetained);
+    tensorPool->setMaxRetainedBytes(maxRetainedBytes);
+}
+
+size_t ab_test_pool_size_class(size_t bytes) {
+    return abacus::TensorPool::sizeClass(bytes);
+}
+
+} // extern "C"
@@ -0,0 +1,245 @@
+// AbacusKit - SorobanDetectorTests
+// Swift 6.2
+
+import AbacusVisionBridge
+import AbacusVisionTestSupport
+import XCTest
+@testable import AbacusKit
+
+/// SorobanDetector の各段を、同じ入力に対する別経路・参照実装と照合するテスト
+final class SorobanDetectorTests: XCTestCase {
+    override func setUpWithError() throws {
+        // 実装は OpenCV 有効時のみリンクされる
+        try XCTSkipUnless(VisionBridge().isValid, "OpenCV が利用できない環境")
+    }
+
+    // MARK: - Warp Cache Tests
+
+    func testWarpCacheReusesTablesWithinTolerance() {
+        let corners = frameCorners(shiftedBy: 0)
+        let nudged = frameCorners(shiftedBy: 0.3)
+
+        // 許容範囲内の移動では前回のテーブルで変換するので、出力は変わらない
+        let cached = warp([corners, nudged], tolerance: 0.5)
+        XCTAssertEqual(cached[1], cached[0])
+
+        // 許容範囲を 0 にすると移動後の 4 隅でテーブルを作り直す
+        let rebuilt = warp([corners, nudged], tolerance: 0)
+        XCTAssertNotEqual(rebuilt[1], rebuilt[0])
+        XCTAssertEqual(rebuilt[1], warp([nudged], tolerance: 0)[0])
+    }
+
+    func testWarpCacheRebuildsWhenCornersMoveBeyondTolerance() {
+        let corners = frameCorners(shiftedBy: 0)
+        let moved = frameCorners(shiftedBy: 2)
+        let outputs = warp([corners, moved, corners], tolerance: 0.5)
+
+        // 移動後は新しい検出器で変換したものと一致する（古いテーブルを使い続けない）
+        XCTAssertNotEqual(outputs[1], outputs[0])
+        XCTAssertEqual(outputs[1], warp([moved], tolerance: 0.5)[0])
+
+        // 元の位置に戻れば、また元の 4 隅で作り直す
+        XCTAssertEqual(outputs[2], outputs[0])
+    }
+
+    // MARK: - Frame Detection Tests
+
+    func testContourPrefilterSelectsSameFrameAsFullScan() {
+        let width = 640, height = 480
+        let binary = clutteredBinary(width, height)
+
+        var expected = ABFrameResult()
+        XCTAssertEqual(
+            ab_test_reference_detect_frame(binary, Int32(width), Int32(height), 0, &expected),
+            Int32(ABVisionErrorNone.rawValue)
+        )
+        XCTAssertTrue(expected.detected)
+        XCTAssertEqual(expected.boundingBox.x, 100)
+        XCTAssertEqual(expected.boundingBox.y, 150)
+        XCTAssertEqual(expected.boundingBox.width, 440)
+        XCTAssertEqual(expected.boundingBox.height, 180)
+
+        // 無制限・既定・近似に進める輪郭を絞った場合のいずれも、全輪郭を調べた結果と同じフレームを選ぶ
+        for limit: Int32 in [0, 32, 4, 1] {
+            var actual = ABFrameResult()
+            XCTAssertEqual(
+                ab_test_detect_frame(binary, Int32(width), Int32(height), 0, limit, &actual),
+                Int32(ABVisionErrorNone.rawValue)
+            )
+            XCTAssertTrue(actual.detected, "maxFrameContours \(limit)")
+            XCTAssertEqual(corners(actual.corners), corners(expected.corners), "maxFrameContours \(limit)")
+            XCTAssertEqual(actual.boundingBox.x, expected.boundingBox.x)
+            XCTAssertEqual(actual.boundingBox.y, expected.boundingBox.y)
+            XCTAssertEqual(actual.boundingBox.width, expected.boundingBox.width)
+            XCTAssertEqual(actual.boundingBox.height, expected.boundingBox.height)
+            XCTAssertEqual(actual.confidence, expected.confidence)
+        }
+    }
+
+    // MARK: - Cell Extraction Tests
+
+    func testCellsAreViewsIntoLane() {
+        // 行末に余白のあるレーンでも、セルはコピーせず元の行ストライドのまま参照する
+        let width = 40, height = 180
+        let bytesPerRow = width * 3 + 24
+        let lane = [UInt8](repeating: 128, count: bytesPerRow * height)
+        var rects = [ABRect](repeating: ABRect(), count: 8)
+        var offsets = [Int64](repeating: 0, count: 8)
+
+        let count = Int(ab_test_extract_cells(
+            lane, Int32(width), Int32(height), bytesPerRow, &rects, &offsets, Int32(rects.count)
+        ))
+        XCTAssertEqual(count, 5)
+        guard count > 0 else { return }
+
+        for i in 0..<count {
+            XCTAssertEqual(rects[i].width, Float(width))
+            XCTAssertEqual(offsets[i], Int64(rects[i].y) * Int64(bytesPerRow) + Int64(rects[i].x) * 3)
+        }
+
+        // 上珠から下珠へ、重ならずにレーン内に並ぶ
+        for i in 1..<count {
+            XCTAssertGreaterThanOrEqual(rects[i].y, rects[i - 1].y + rects[i - 1].height)
+        }
+        XCTAssertLessThanOrEqual(rects[count - 1].y + rects[count - 1].height, Float(height))
+    }
+
+    // MARK: - Column Projection Tests
+
+    func testColumnProjectionMatchesSobelReference() {
+        // 模様の左上 203 × 61 を行ストライドそのままで使う（幅はベクトル幅の倍数にしない）
+        let width = 203, height = 61
+
+        // 全体、中ほどの行帯（帯の外の行も近傍として使う）、画像外にはみ出す行帯、最終行のみ
+        for (rowBegin, rowEnd) in [(0, height), (20, 37), (-5, 500), (height - 1, height)] {
+            XCTAssertEqual(
+                projectColumns(width, height, rowBegin, rowEnd, using: ab_test_project_columns),
+                projectColumns(width, height, rowBegin, rowEnd, using: ab_test_reference_project_columns),
+                "rows \(rowBegin)..<\(rowEnd)"
+            )
+        }
+    }
+
+    // MARK: - Lane Count Tests
+
+    func testLaneBoundariesOnFlatToppedProjection() {
+        // 明るい背景に幅 24px の暗い珠棒を 100px 間隔で 7 本置く
+        let width = 800, height = 200
+        let bars = Array(stride(from: 100, through: 700, by: 100))
+        var frame = [UInt8](repeating: 200, count: width * height)
+        for y in 0..<height {
+            for bar in bars {
+                for x in bar..<(bar + 24) {
+                    frame[y * width + x] = 60
+                }
+            }
+        }
+
+        // 各縁で Sobel が飽和し、射影は隣り合う 2 列で同じ値の平らな山になる。
+        // 山ごとに左端の 1 列だけが境界候補になる
+        var peaks = [Int32](repeating: -1, count: 32)
+        var peakCount: Int32 = 0
+        let laneCount = ab_test_detect_lane_count(
+            frame, Int32(width), Int32(height), 0, &peaks, Int32(peaks.count), &peakCount
+        )
+        let expected = bars.flatMap { [Int32($0 - 1), Int32($0 + 23)] }
+        XCTAssertEqual(Array(peaks.prefix(Int(peakCount))), expected)
+        XCTAssertEqual(laneCount, Int32(expected.count - 1))
+    }
+
+    // MARK: - Helpers
+
+    private let imageWidth = 320
+    private let imageHeight = 240
+
+    /// 補間位置が 1/32 画素ずれても出力が変わる程度に細かい模様
+    private lazy var texture: [UInt8] = {
+        var state: UInt32 = 4242
+        return (0..<(imageWidth * imageHeight)).map { _ in
+            state = state &* 1_664_525 &+ 1_013_904_223
+            return UInt8(truncatingIfNeeded: state >> 24)
+        }
+    }()
+
+    /// 少し傾いたフレームの 4 隅（x 方向に shift だけ動かす）
+    private func frameCorners(shiftedBy shift: Float) -> ABQuadrilateral {
+        ABQuadrilateral(
+            topLeft: ABPoint(x: 40 + shift, y: 50),
+            topRight: ABPoint(x: 280 + shift, y: 60),
+            bottomRight: ABPoint(x: 270 + shift, y: 200),
+            bottomLeft: ABPoint(x: 30 + shift, y: 190)
+        )
+    }
+
+    /// フレームと紛らわしい輪郭を並べた二値画像
+    /// フレーム (100, 150)〜(539, 329) のほか、上側に小さな正方形 60 個と細長い平行四辺形
+    /// （4 頂点のフレーム候補だが面積はフレームより小さい）、下側に直角三角形 3 つを置く。
+    private func clutteredBinary(_ width: Int, _ height: Int) -> [UInt8] {
+        var binary = [UInt8](repeating: 0, count: width * height)
+        func fill(_ y: Int, _ xs: Range<Int>) {
+            for x in xs {
+                binary[y * width + x] = 255
+            }
+        }
+
+        for y in 150..<330 {
+            fill(y, 100..<540)
+        }
+        for y in 75..<135 {
+            let shift = (y - 75) * 40 / 60
+            fill(y, (20 + shift)..<(560 + shift))
+        }
+        for i in 0..<60 {
+            let x = 10 + (i % 30) * 20
+            let y = 10 + (i / 30) * 25
+            for row in y..<(y + 5) {
+                fill(row, x..<(x + 5))
+            }
+        }
+        for x0 in [10, 220, 430] {
+            for y in 345..<475 {
+                fill(y, x0..<(x0 + 1 + (y - 345) * 190 / 130))
+            }
+        }
+        return binary
+    }
+
+    /// 4 隅を比較できる形にする
+    private func corners(_ quad: ABQuadrilateral) -> [Float] {
+        [
+            quad.topLeft.x, quad.topLeft.y, quad.topRight.x, quad.topRight.y,
+            quad.bottomRight.x, quad.bottomRight.y, quad.bottomLeft.x, quad.bottomLeft.y,
+        ]
+    }
+
+    /// 模様の左上 width × height の列射影
+    private func projectColumns(
+        _ width: Int,
+        _ height: Int,
+        _ rowBegin: Int,
+        _ rowEnd: Int,
+        using project: (UnsafePointer<UInt8>?, Int32, Int32, Int, Int32, Int32, UnsafeMutablePointer<Int32>?) -> Int32
+    ) -> [Int32] {
+        var projection = [Int32](repeating: -1, count: width)
+        let error = project(
+            texture, Int32(width), Int32(height), imageWidth,
+            Int32(rowBegin), Int32(rowEnd), &projection
+        )
+        XCTAssertEqual(error, Int32(ABVisionErrorNone.rawValue))
+        return projection
+    }
+
+    /// 1 つの検出器で corners の順に射影変換した出力（200 × 50）
+    private func warp(_ corners: [ABQuadrilateral], tolerance: Float) -> [[UInt8]] {
+        let outputWidth = 200, outputHeight = 50
+        let size = outputWidth * outputHeight
+        var outputs = [UInt8](repeating: 0, count: corners.count * size)
+        let error = ab_test_warp_frames(
+            texture, Int32(imageWidth), Int32(imageHeight), 0,
+            corners, Int32(corners.count), tolerance,
+            Int32(outputWidth), Int32(outputHeight), &outputs
+        )
+        XCTAssertEqual(error, Int32(ABVisionErrorNone.rawValue))
+        return (0..<corners.count).map { Array(outputs[($0 * size)..<(($0 + 1) * size)]) }
+    }
+}
@@ -0,0 +1,258 @@
+// AbacusKit - TensorConverterTests
+// Swift 6.2
+
+import AbacusVisionBridge
+import AbacusVisionTestSupport
+import XCTest
+@testable import AbacusKit
+
+/// TensorConverter の出力を、OpenCV による参照実装や別の設定での変換結果と照合するテスト
+final class TensorConverterTests: XCTestCase {
+    /// 詰めて配置したセル画像の列
+    private struct Cells {
+        let width: Int
+        let height: Int
+        let channels: Int
+        let count: Int
+        let pixels: [UInt8]
+    }
+
+    /// 既定の設定（単一スレッドで変換する）
+    private var baseConfig = ABVisionConfig()
+
+    override func setUpWithError() throws {
+        // 実装は OpenCV 有効時のみリンクされる
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+        baseConfig = try XCTUnwrap(bridge.configuration)
+        baseConfig.conversionThreads = 1
+    }
+
+    // MARK: - Fused Resize Tests
+
+    func testFusedResizeMatchesOpenCVReference() {
+        let cells = noiseCells(width: 37, height: 53, channels: 3, count: 3)
+
+        // 1 チャンネル出力ではリサイズの前に輝度へ変換する
+        for channels: Int32 in [3, 1] {
+            var config = baseConfig
+            config.tensorChannels = channels
+            let actual = convert(cells, config, as: Float.self)
+            XCTAssertEqual(actual.error, Int32(ABVisionErrorNone.rawValue))
+            assertWithinOneLevel(actual.values, reference(cells, config), config)
+        }
+    }
+
+    func testFusedResizeMatchesReferenceAtEveryOutputSize() {
+        // 拡大と縮小の両方（縦横で倍率が異なる）
+        let small = noiseCells(width: 37, height: 53, channels: 3, count: 2)
+        let large = noiseCells(width: 300, height: 260, channels: 3, count: 2, seed: 7)
+
+        for size: Int32 in [32, 64, 96, 100, 224] {
+            var config = baseConfig
+            config.cellOutputSize = size
+            for cells in [small, large] {
+                let actual = convert(cells, config, as: Float.self)
+                XCTAssertEqual(actual.error, Int32(ABVisionErrorNone.rawValue))
+                assertWithinOneLevel(actual.values, reference(cells, config), config)
+            }
+        }
+    }
+
+    // MARK: - Normalization Table Tests
+
+    func testNormalizationTablesFollowUpdatedMeanAndStd() {
+        // 出力サイズと同じセルは補間しないので、差は正規化の係数だけから生じる
+        let cells = noiseCells(width: 32, height: 32, channels: 3, count: 2)
+
+        for channels: Int32 in [3, 1] {
+            var initial = baseConfig
+            initial.cellOutputSize = 32
+            initial.tensorChannels = channels
+            var updated = initial
+            updated.mean = (0.5, 0.25, 0.75)
+            updated.std = (0.5, 0.125, 0.25)
+            updated.meanGray = 0.3
+            updated.stdGray = 0.4
+
+            let floats = convert(cells, updated, as: Float.self, previous: initial)
+            XCTAssertEqual(floats.error, Int32(ABVisionErrorNone.rawValue))
+            XCTAssertEqual(floats.values, convert(cells, updated, as: Float.self).values)
+            XCTAssertNotEqual(floats.values, convert(cells, initial, as: Float.self).values)
+            let expected = reference(cells, updated)
+            for (actual, value) in zip(floats.values, expected) {
+                XCTAssertEqual(actual, value, accuracy: 1e-5)
+            }
+
+            // Float16 のテーブルも作り直される
+            initial.tensorDataType = ABTensorDataTypeFloat16
+            updated.tensorDataType = ABTensorDataTypeFloat16
+            let halves = convert(cells, updated, as: UInt16.self, previous: initial)
+            XCTAssertEqual(halves.error, Int32(ABVisionErrorNone.rawValue))
+            XCTAssertEqual(halves.values, convert(cells, updated, as: UInt16.self).values)
+            XCTAssertNotEqual(halves.values, convert(cells, initial, as: UInt16.self).values)
+        }
+    }
+
+    // MARK: - Layout Tests
+
+    func testInterleavedLayoutHoldsSameValuesAsPlanar() {
+        // 出力幅をベクトル幅の倍数にせず、端数の処理も通す
+        let cells = noiseCells(width: 37, height: 53, channels: 3, count: 2)
+        var planar = baseConfig
+        planar.cellOutputSize = 40
+        var interleaved = planar
+        interleaved.tensorLayout = ABTensorLayoutNHWC
+
+        planar.tensorDataType = ABTensorDataTypeUInt8
+        interleaved.tensorDataType = ABTensorDataTypeUInt8
+        XCTAssertEqual(
+            toPlanar(convert(cells, interleaved, as: UInt8.self).values, 40),
+            convert(cells, planar, as: UInt8.self).values
+        )
+
+        planar.tensorDataType = ABTensorDataTypeFloat16
+        interleaved.tensorDataType = ABTensorDataTypeFloat16
+        XCTAssertEqual(
+            toPlanar(convert(cells, interleaved, as: UInt16.self).values, 40),
+            convert(cells, planar, as: UInt16.self).values
+        )
+
+        planar.tensorDataType = ABTensorDataTypeFloat32
+        interleaved.tensorDataType = ABTensorDataTypeFloat32
+        let expected = convert(cells, planar, as: Float.self).values
+        let actual = toPlanar(convert(cells, interleaved, as: Float.self).values, 40)
+        XCTAssertEqual(actual.count, expected.count)
+        for (a, e) in zip(actual, expected) {
+            XCTAssertEqual(a, e, accuracy: 1e-6)
+        }
+    }
+
+    // MARK: - Parallel Conversion Tests
+
+    func testParallelConversionMatchesSequential() {
+        let cells = noiseCells(width: 37, height: 53, channels: 3, count: 24)
+        var config = baseConfig
+        config.cellOutputSize = 64
+        config.parallelMinCells = 1
+        let sequential = convert(cells, config, as: Float.self)
+        XCTAssertEqual(sequential.error, Int32(ABVisionErrorNone.rawValue))
+
+        // 自動・スレッド数指定のどちらでも、各セルは単一スレッドと同じ位置に同じ値で書かれる
+        for threads: Int32 in [0, 2] {
+            config.conversionThreads = threads
+            let parallel = convert(cells, config, as: Float.self)
+            XCTAssertEqual(parallel.error, Int32(ABVisionErrorNone.rawValue))
+            XCTAssertEqual(parallel.values, sequential.values)
+        }
+    }
+
+    func testParallelConversionReportsCellErrors() {
+        let cells = noiseCells(width: 37, height: 53, channels: 3, count: 24)
+        var config = baseConfig
+        config.cellOutputSize = 32
+        config.parallelMinCells = 1
+        config.conversionThreads = 2
+
+        // 途中のセルの失敗が、分割した区間の外にも伝わって全体の失敗になる
+        let failed = convert(cells, config, as: Float.self, emptyCell: 17)
+        XCTAssertEqual(failed.error, Int32(ABVisionErrorInvalidInput.rawValue))
+
+        let required = elementCount(cells.count, config)
+        let short = convert(cells, config, as: Float.self, capacity: required - 1)
+        XCTAssertEqual(short.error, Int32(ABVisionErrorMemoryAllocationFailed.rawValue))
+    }
+
+    // MARK: - Helpers
+
+    /// 乱数の模様を持つセル画像（補間位置や丸めの違いが出力に現れるようにする）
+    private func noiseCells(width: Int, height: Int, channels: Int, count: Int, seed: UInt32 = 2024) -> Cells {
+        var state = seed
+        let pixels = (0..<(width * height * channels * count)).map { _ -> UInt8 in
+            state = state &* 1_664_525 &+ 1_013_904_223
+            return UInt8(truncatingIfNeeded: state >> 24)
+        }
+        return Cells(width: width, height: height, channels: channels, count: count, pixels: pixels)
+    }
+
+    /// cellCount 個のセルのテンソルの要素数
+    private func elementCount(_ cellCount: Int, _ config: ABVisionConfig) -> Int {
+        let size = Int(config.cellOutputSize)
+        return cellCount * (config.tensorChannels == 1 ? 1 : 3) * size * size
+    }
+
+    /// TensorConverter で変換する
+    /// - Parameters:
+    ///   - previous: 先に適用しておく設定（setConfig で config に切り替える）
+    ///   - emptyCell: 空の画像に置き換えるセルの番号
+    ///   - capacity: 出力の要素数（nil なら必要な数）
+    private func convert<Element: Numeric>(
+        _ cells: Cells,
+        _ config: ABVisionConfig,
+        as _: Element.Type,
+        previous: ABVisionConfig? = nil,
+        emptyCell: Int = -1,
+        capacity: Int? = nil
+    ) -> (error: Int32, values: [Element]) {
+        var current = config
+        var initial = previous ?? config
+        let count = capacity ?? elementCount(cells.count, config)
+        var output = [Element](repeating: 0, count: count)
+        let error = withUnsafePointer(to: &initial) { initialPointer in
+            output.withUnsafeMutableBytes { bytes in
+                ab_test_convert_cells(
+                    &current, previous == nil ? nil : initialPointer,
+                    cells.pixels, Int32(cells.width), Int32(cells.height), Int32(cells.channels),
+                    Int32(cells.count), Int32(emptyCell), bytes.baseAddress, count
+                )
+            }
+        }
+        return (error, output)
+    }
+
+    /// 参照実装で Float32 に変換する
+    private func reference(_ cells: Cells, _ config: ABVisionConfig) -> [Float] {
+        var current = config
+        let count = elementCount(cells.count, config)
+        var output = [Float](repeating: 0, count: count)
+        let error = ab_test_reference_cells(
+            &current, cells.pixels, Int32(cells.width), Int32(cells.height), Int32(cells.channels),
+            Int32(cells.count), &output, count
+        )
+        XCTAssertEqual(error, Int32(ABVisionErrorNone.rawValue))
+        return output
+    }
+
+    /// 3 チャンネルの NHWC テンソルを NCHW に並べ替える
+    private func toPlanar<Element>(_ values: [Element], _ size: Int) -> [Element] {
+        let plane = size * size
+        let cellElements = plane * 3
+        var result = values
+        for index in values.indices {
+            let cell = index / cellElements
+            let pixel = index % cellElements / 3
+            let channel = index % 3
+            result[cell * cellElements + channel * plane + pixel] = values[index]
+        }
+        return result
+    }
+
+    /// 正規化後の値の差が、補間結果の 1 階調分以内であること
+    private func assertWithinOneLevel(
+        _ actual: [Float],
+        _ expected: [Float],
+        _ config: ABVisionConfig,
+        file: StaticString = #filePath,
+        line: UInt = #line
+    ) {
+        XCTAssertEqual(actual.count, expected.count, file: file, line: line)
+
+        // 1 階調が最も大きく変わるチャンネルで判定する（丸め誤差の分だけ余裕を持たせる）
+        let minStd = config.tensorChannels == 1
+            ? config.stdGray
+            : min(config.std.0, config.std.1, config.std.2)
+        let tolerance = 1.0001 / (255 * minStd)
+        let worst = zip(actual, expected).map { abs($0 - $1) }.max() ?? 0
+        XCTAssertLessThanOrEqual(worst, tolerance, file: file, line: line)
+    }
+}
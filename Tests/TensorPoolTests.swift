@@ -0,0 +1,106 @@
+// AbacusKit - TensorPoolTests
+// Swift 6.2
+
+import AbacusVisionTestSupport
+import XCTest
+
+/// TensorPool の容量クラスによる再利用と、未使用バッファの上限を検証するテスト
+/// 共有プールの状態に影響しないよう、テストごとに別のプールを作る。
+final class TensorPoolTests: XCTestCase {
+    private var pool: UnsafeMutableRawPointer?
+
+    override func setUp() {
+        pool = ab_test_pool_create()
+    }
+
+    override func tearDown() {
+        ab_test_pool_destroy(pool)
+        pool = nil
+    }
+
+    // MARK: - Size Class Tests
+
+    func testSizeClassRoundsUpToQuarterSteps() {
+        XCTAssertEqual(ab_test_pool_size_class(1), 4096)
+        XCTAssertEqual(ab_test_pool_size_class(4096), 4096)
+        XCTAssertEqual(ab_test_pool_size_class(5000), 5120)
+        XCTAssertEqual(ab_test_pool_size_class(5120), 5120)
+        XCTAssertEqual(ab_test_pool_size_class(5121), 6144)
+        XCTAssertEqual(ab_test_pool_size_class(1_000_000), 1_048_576)
+    }
+
+    func testSameSizeClassReusesReleasedBuffer() throws {
+        let first = try XCTUnwrap(ab_test_pool_acquire(pool, 5000))
+        XCTAssertTrue(ab_test_pool_release(pool, first))
+
+        // セル数が少し増えても同じ容量クラスなら同じバッファが返る
+        let second = try XCTUnwrap(ab_test_pool_acquire(pool, 5100))
+        XCTAssertEqual(second, first)
+        XCTAssertTrue(ab_test_pool_release(pool, second))
+
+        // 別の容量クラスでは再利用しない
+        let larger = try XCTUnwrap(ab_test_pool_acquire(pool, 6000))
+        XCTAssertNotEqual(larger, first)
+        XCTAssertTrue(ab_test_pool_release(pool, larger))
+    }
+
+    func testBuffersAreAligned() throws {
+        for bytes in [1, 4097, 5000, 100_000, 3 * 224 * 224 * 4 * 25] {
+            let buffer = try XCTUnwrap(ab_test_pool_acquire(pool, bytes))
+            XCTAssertEqual(Int(bitPattern: buffer) % 64, 0)
+            XCTAssertTrue(ab_test_pool_release(pool, buffer))
+        }
+    }
+
+    func testForeignBufferIsNotAccepted() {
+        var local = [UInt8](repeating: 0, count: 64)
+        local.withUnsafeMutableBytes { bytes in
+            XCTAssertFalse(ab_test_pool_release(pool, bytes.baseAddress))
+        }
+        XCTAssertFalse(ab_test_pool_release(pool, nil))
+
+        // 別のプールが確保したバッファも受け取らない
+        let other = ab_test_pool_create()
+        defer { ab_test_pool_destroy(other) }
+        let buffer = ab_test_pool_acquire(other, 5000)
+        XCTAssertFalse(ab_test_pool_release(pool, buffer))
+        XCTAssertTrue(ab_test_pool_release(other, buffer))
+    }
+
+    // MARK: - Eviction Tests
+
+    func testRetainedCountLimitEvictsOldest() throws {
+        ab_test_pool_set_limits(pool, 2, Int.max)
+        let buffers = try (0..<3).map { _ in try XCTUnwrap(ab_test_pool_acquire(pool, 5000)) }
+        for buffer in buffers {
+            XCTAssertTrue(ab_test_pool_release(pool, buffer))
+        }
+
+        // 最初に返却したものが解放され、残りは直近の返却から順に再利用される
+        XCTAssertEqual(ab_test_pool_acquire(pool, 5000), buffers[2])
+        XCTAssertEqual(ab_test_pool_acquire(pool, 5000), buffers[1])
+    }
+
+    func testRetainedByteLimitEvictsOldest() throws {
+        // 5120 バイトのクラスを 2 つ分だけ残せる
+        ab_test_pool_set_limits(pool, 16, 2 * 5120)
+        let buffers = try (0..<3).map { _ in try XCTUnwrap(ab_test_pool_acquire(pool, 5000)) }
+        for buffer in buffers {
+            XCTAssertTrue(ab_test_pool_release(pool, buffer))
+        }
+
+        XCTAssertEqual(ab_test_pool_acquire(pool, 5000), buffers[2])
+        XCTAssertEqual(ab_test_pool_acquire(pool, 5000), buffers[1])
+    }
+
+    func testLoweringLimitEvictsRetainedBuffers() throws {
+        let buffers = try (0..<3).map { _ in try XCTUnwrap(ab_test_pool_acquire(pool, 5000)) }
+        for buffer in buffers {
+            XCTAssertTrue(ab_test_pool_release(pool, buffer))
+        }
+
+        // 上限を下げた時点で古いものから解放する
+        ab_test_pool_set_limits(pool, 1, Int.max)
+        XCTAssertEqual(ab_test_pool_acquire(pool, 5000), buffers[2])
+    }
+}
@@ -0,0 +1,225 @@
+// AbacusKit - VisionAlgorithmTests
+// Swift 6.2
+
+import AbacusVisionBridge
+import AbacusVisionTestSupport
+import XCTest
+@testable import AbacusKit
+
+/// C++ 側の数値処理を既知の答えと照合するテスト
+final class VisionAlgorithmTests: XCTestCase {
+    override func setUpWithError() throws {
+        // 実装は OpenCV 有効時のみリンクされる
+        try XCTSkipUnless(VisionBridge().isValid, "OpenCV が利用できない環境")
+    }
+
+    // MARK: - Float16 Conversion Tests
+
+    func testHalfRoundTripsEveryFiniteValue() {
+        // binary16 で表せる値は float を経由しても同じビット列に戻る
+        var mismatches = 0
+        for bits in UInt16.min...UInt16.max where bits & 0x7c00 != 0x7c00 {
+            if ab_test_float_to_half(halfToFloat(bits)) != bits {
+                mismatches += 1
+            }
+        }
+        XCTAssertEqual(mismatches, 0)
+    }
+
+    func testHalfKnownValues() {
+        XCTAssertEqual(ab_test_float_to_half(1.0), 0x3c00)
+        XCTAssertEqual(ab_test_float_to_half(-2.0), 0xc000)
+        XCTAssertEqual(ab_test_float_to_half(0.1), 0x2e66)
+        XCTAssertEqual(ab_test_float_to_half(1.0 / 3.0), 0x3555)
+        XCTAssertEqual(ab_test_float_to_half(-0.0), 0x8000)
+    }
+
+    func testHalfRoundsToNearestEven() {
+        // 1 + 2^-11 はちょうど中間なので偶数側（1.0）へ、1 + 3·2^-11 は 1 + 2^-9 へ
+        XCTAssertEqual(ab_test_float_to_half(1.0 + 0x1p-11), 0x3c00)
+        XCTAssertEqual(ab_test_float_to_half(1.0 + 0x3p-11), 0x3c02)
+    }
+
+    func testHalfDenormals() {
+        XCTAssertEqual(ab_test_float_to_half(0x1p-14), 0x0400)            // 最小の正規化数
+        XCTAssertEqual(ab_test_float_to_half(0x3ffp-24), 0x03ff)          // 最大の非正規化数
+        XCTAssertEqual(ab_test_float_to_half(0x1p-24), 0x0001)            // 最小の非正規化数
+        XCTAssertEqual(ab_test_float_to_half(0x1.8p-25), 0x0001)          // 中間より上は切り上げ
+        XCTAssertEqual(ab_test_float_to_half(0x1p-25), 0x0000)            // 中間は偶数（0）へ
+        XCTAssertEqual(ab_test_float_to_half(0x1p-26), 0x0000)
+        XCTAssertEqual(ab_test_float_to_half(-0x1p-24), 0x8001)
+    }
+
+    func testHalfOverflow() {
+        XCTAssertEqual(ab_test_float_to_half(65504), 0x7bff)              // 最大の有限値
+        XCTAssertEqual(ab_test_float_to_half(65519), 0x7bff)              // 中間未満は有限値に丸まる
+        XCTAssertEqual(ab_test_float_to_half(65520), 0x7c00)              // 中間以上は inf
+        XCTAssertEqual(ab_test_float_to_half(1e5), 0x7c00)
+        XCTAssertEqual(ab_test_float_to_half(-1e5), 0xfc00)
+        XCTAssertEqual(ab_test_float_to_half(.infinity), 0x7c00)
+
+        let nan = ab_test_float_to_half(.nan)
+        XCTAssertEqual(nan & 0x7c00, 0x7c00)
+        XCTAssertNotEqual(nan & 0x03ff, 0)
+    }
+
+    // MARK: - Peak Detection Tests
+
+    func testWindowPeaksKnownAnswer() {
+        // 端の 5 は窓が収まらないので除外、7 の台地は左端のみ、3 は閾値以下
+        let signal: [Int32] = [5, 0, 2, 7, 7, 1, 0, 3, 0, 9, 4, 0, 5]
+        XCTAssertEqual(peaks(signal, radius: 1, threshold: 3), [3, 9])
+        XCTAssertEqual(peaks(signal, radius: 2, threshold: 0), [3, 9])
+        XCTAssertEqual(peaks(signal, radius: 1, threshold: 2), [3, 7, 9])
+        XCTAssertEqual(peaks(signal, radius: 7, threshold: 0), [])
+    }
+
+    func testWindowPeaksMatchBruteForce() {
+        // 値域を狭くして同値（台地・窓内の重複最大）を多く含ませる
+        var state: UInt32 = 2024
+        for trial in 0..<200 {
+            let length = 1 + trial % 97
+            let signal: [Int32] = (0..<length).map { _ in
+                state = state &* 1_664_525 &+ 1_013_904_223
+                return Int32(state >> 29)
+            }
+
+            for radius in [0, 1, 2, 5, 13] {
+                for threshold: Int32 in [-1, 0, 3] {
+                    XCTAssertEqual(
+                        peaks(signal, radius: radius, threshold: threshold),
+                        bruteForcePeaks(signal, radius: radius, threshold: threshold),
+                        "trial \(trial), radius \(radius), threshold \(threshold)"
+                    )
+                }
+            }
+        }
+    }
+
+    func testWindowPeaksReportsTotalBeyondCapacity() {
+        let signal: [Int32] = [0, 4, 0, 4, 0, 4, 0]
+        var output = [Int32](repeating: -1, count: 2)
+        let count = ab_test_find_peaks(signal, Int32(signal.count), 1, 0, &output, 2)
+
+        XCTAssertEqual(count, 3)
+        XCTAssertEqual(output, [1, 3])
+    }
+
+    // MARK: - Rod Pitch Tests
+
+    func testRodPitchOfPeriodicProjection() {
+        let projection = rodProjection(length: 600, first: 12, pitch: 30, count: 20)
+        let rods = estimateRodPitch(projection)
+
+        XCTAssertTrue(rods.valid)
+        XCTAssertEqual(rods.pitch, 30, accuracy: 0.25)
+        XCTAssertEqual(rods.phase, 12, accuracy: 1)
+        XCTAssertGreaterThan(rods.confidence, 0.5)
+    }
+
+    func testRodPitchOfFullAbacusWithinBorder() {
+        // 27 桁が幅 800 のうち左右 40px の枠を除いた範囲に並ぶ（間隔は 幅 / 28 より狭い）
+        let pitch = 720.0 / 27
+        let projection = rodProjection(length: 800, first: 40 + pitch / 2, pitch: pitch, count: 27, border: 40)
+        let rods = estimateRodPitch(projection, maxLaneCount: 27)
+
+        XCTAssertTrue(rods.valid)
+        XCTAssertEqual(rods.pitch, pitch, accuracy: 0.3)
+        XCTAssertEqual(rods.rodCount, 27)
+        XCTAssertEqual(rods.firstRod, 40 + pitch / 2, accuracy: 1)
+    }
+
+    func testRodsExcludeBorderWiderThanHalfPitch() {
+        // 枠が 150px（間隔 40 の 3 周期以上）あっても格子を枠まで広げない
+        let projection = rodProjection(length: 700, first: 170, pitch: 40, count: 10, border: 150)
+        let rods = estimateRodPitch(projection)
+
+        XCTAssertTrue(rods.valid)
+        XCTAssertEqual(rods.rodCount, 10)
+        XCTAssertEqual(rods.firstRod, 170, accuracy: 1)
+    }
+
+    func testRodCountCapKeepsUnitsDigit() {
+        // 上限を超える分は支えの弱い側（ここでは左端の 2 本）から除き、右端の一の位は残す
+        let pitch = 720.0 / 27
+        let projection = rodProjection(
+            length: 800, first: 40 + pitch / 2, pitch: pitch, count: 27, border: 40,
+            amplitude: { $0 < 2 ? 60 : 100 }
+        )
+        let rods = estimateRodPitch(projection, maxLaneCount: 25)
+
+        XCTAssertEqual(rods.rodCount, 25)
+        XCTAssertEqual(rods.firstRod + 24 * rods.pitch, 760 - pitch / 2, accuracy: 1.5)
+    }
+
+    // MARK: - Helpers
+
+    private func estimateRodPitch(
+        _ projection: [Int32],
+        minLaneCount: Int32 = 1,
+        maxLaneCount: Int32 = 27
+    ) -> ABRodPitch {
+        var rods = ABRodPitch()
+        let error = ab_test_estimate_rod_pitch(
+            projection, Int32(projection.count), minLaneCount, maxLaneCount, &rods
+        )
+        XCTAssertEqual(error, Int32(ABVisionErrorNone.rawValue))
+        return rods
+    }
+
+    /// 珠棒ごとに山を持つ列射影（border を指定すると枠の縁に強いエッジを加える、amplitude は珠棒ごとの高さ）
+    private func rodProjection(
+        length: Int,
+        first: Double,
+        pitch: Double,
+        count: Int,
+        border: Int? = nil,
+        amplitude: (Int) -> Double = { _ in 100 }
+    ) -> [Int32] {
+        func bump(_ x: Int, _ center: Double, _ sigma: Double) -> Double {
+            let d = (Double(x) - center) / sigma
+            return exp(-0.5 * d * d)
+        }
+
+        return (0..<length).map { x in
+            var value = (0..<count).reduce(0.0) { sum, i in
+                sum + amplitude(i) * bump(x, first + Double(i) * pitch, 2)
+            }
+            if let border {
+                value += 300 * bump(x, Double(border), 1)
+                value += 300 * bump(x, Double(length - 1 - border), 1)
+            }
+            return Int32(value.rounded())
+        }
+    }
+
+    private func peaks(_ signal: [Int32], radius: Int, threshold: Int32) -> [Int32] {
+        var output = [Int32](repeating: 0, count: signal.count)
+        let count = ab_test_find_peaks(
+            signal, Int32(signal.count), Int32(radius), threshold,
+            &output, Int32(output.count)
+        )
+        return Array(output.prefix(Int(count)))
+    }
+
+    /// 窓ごとに最大値を数え直す素朴な実装
+    private func bruteForcePeaks(_ signal: [Int32], radius: Int, threshold: Int32) -> [Int32] {
+        guard signal.count > 2 * radius else { return [] }
+        return (radius..<(signal.count - radius)).compactMap { center in
+            let window = signal[(center - radius)...(center + radius)]
+            let leftmostMax = window.firstIndex(of: window.max()!)!
+            return leftmostMax == center && signal[center] > threshold ? Int32(center) : nil
+        }
+    }
+
+    /// binary16 のビット列を float に展開（Float16 型を使わずに済むように）
+    private func halfToFloat(_ bits: UInt16) -> Float {
+        let sign: FloatingPointSign = bits & 0x8000 != 0 ? .minus : .plus
+        let exponent = Int((bits >> 10) & 0x1f)
+        let mantissa = Float(bits & 0x03ff)
+        if exponent == 0 {
+            return Float(sign: sign, exponent: -24, significand: mantissa)
+        }
+        return Float(sign: sign, exponent: exponent - 25, significand: 1024 + mantissa)
+    }
+}
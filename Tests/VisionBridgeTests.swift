@@ -1,6 +1,8 @@
 // AbacusKit - VisionBridgeTests
 // Swift 6.2
 
+import AbacusVisionBridge
+import AbacusVisionTestSupport
 import XCTest
 @testable import AbacusKit
 
@@ -33,6 +35,173 @@ final class VisionBridgeTests: XCTestCase {
         // Note: 実際のテストには CVPixelBuffer のモックが必要
     }
 
+    // MARK: - Buffer Ingestion Tests
+
+    func testPackedBufferWithRowPaddingIsAccepted() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        // 行末に 16 バイトの余白を持つ BGRA（無地なのでフレームは見つからない）
+        let width = 64, height = 48, stride = width * 4 + 16
+        var pixels = [UInt8](repeating: 128, count: stride * height)
+
+        let error = pixels.withUnsafeMutableBytes { bytes in
+            processError(bridge, makeBuffer(bytes.baseAddress, width, height, stride, ABPixelFormatBGRA))
+        }
+
+        // 入力としては受理され、検出段の失敗がそのまま返る
+        XCTAssertTrue(isFrameNotDetected(error))
+    }
+
+    func testBiPlanarBufferWithSeparateChromaIsAccepted() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        // Y と UV を別々の領域に置いた NV12
+        let width = 64, height = 48
+        var luma = [UInt8](repeating: 128, count: width * height)
+        var chroma = [UInt8](repeating: 128, count: width * height / 2)
+
+        let error = luma.withUnsafeMutableBytes { lumaBytes in
+            chroma.withUnsafeMutableBytes { chromaBytes in
+                var buffer = makeBuffer(lumaBytes.baseAddress, width, height, width, ABPixelFormatNV12)
+                buffer.chromaData.0 = UnsafeRawPointer(chromaBytes.baseAddress)
+                buffer.chromaBytesPerRow.0 = width
+                return processError(bridge, buffer)
+            }
+        }
+
+        XCTAssertTrue(isFrameNotDetected(error))
+    }
+
+    func testPlanarBufferWithSeparateChromaIsAccepted() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        // U と V を別々の領域に置いた I420（行末に余白あり）
+        let width = 64, height = 48, chromaStride = width / 2 + 8
+        var luma = [UInt8](repeating: 128, count: width * height)
+        var u = [UInt8](repeating: 128, count: chromaStride * height / 2)
+        var v = [UInt8](repeating: 128, count: chromaStride * height / 2)
+
+        let error = luma.withUnsafeMutableBytes { lumaBytes in
+            u.withUnsafeMutableBytes { uBytes in
+                v.withUnsafeMutableBytes { vBytes in
+                    var buffer = makeBuffer(lumaBytes.baseAddress, width, height, width, ABPixelFormatI420)
+                    buffer.chromaData = (UnsafeRawPointer(uBytes.baseAddress), UnsafeRawPointer(vBytes.baseAddress))
+                    buffer.chromaBytesPerRow = (chromaStride, chromaStride)
+                    return processError(bridge, buffer)
+                }
+            }
+        }
+
+        XCTAssertTrue(isFrameNotDetected(error))
+    }
+
+    func testStrideShorterThanRowIsInvalidInput() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        // 1 行分に満たないストライドは実行時に範囲外を読むので拒否される
+        let width = 64, height = 48, stride = width * 4 - 4
+        var pixels = [UInt8](repeating: 128, count: width * 4 * height)
+
+        let error = pixels.withUnsafeMutableBytes { bytes in
+            processError(bridge, makeBuffer(bytes.baseAddress, width, height, stride, ABPixelFormatBGRA))
+        }
+
+        guard case let .preprocessingFailed(_, code) = error else {
+            return XCTFail("Expected invalid input, got \(String(describing: error))")
+        }
+        XCTAssertEqual(code, Int(ABVisionErrorInvalidInput.rawValue))
+    }
+
+    // MARK: - Configuration Tests
+
+    func testConfigurationRoundTrips() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        var config = try XCTUnwrap(bridge.configuration)
+        XCTAssertEqual(config.tensorDataType, ABTensorDataTypeFloat32)
+        XCTAssertEqual(config.tensorLayout, ABTensorLayoutNCHW)
+        XCTAssertEqual(config.tensorChannels, 3)
+
+        config.tensorDataType = ABTensorDataTypeFloat16
+        config.tensorLayout = ABTensorLayoutNHWC
+        config.cellOutputSize = 96
+        config.adaptiveMethod = ABAdaptiveThresholdIntegral
+        config.detectionLongEdge = 360
+        config.conversionThreads = 2
+        config.enableDirectCellWarp = true
+        try bridge.setConfiguration(config)
+
+        let updated = try XCTUnwrap(bridge.configuration)
+        XCTAssertEqual(updated.tensorDataType, ABTensorDataTypeFloat16)
+        XCTAssertEqual(updated.tensorLayout, ABTensorLayoutNHWC)
+        XCTAssertEqual(updated.cellOutputSize, 96)
+        XCTAssertEqual(updated.adaptiveMethod, ABAdaptiveThresholdIntegral)
+        XCTAssertEqual(updated.detectionLongEdge, 360)
+        XCTAssertEqual(updated.conversionThreads, 2)
+        XCTAssertTrue(updated.enableDirectCellWarp)
+    }
+
+    func testConfigurationRejectsOutOfRangeValues() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        var config = try XCTUnwrap(bridge.configuration)
+        config.cellOutputSize = 64
+        config.tensorChannels = 2
+
+        XCTAssertThrowsError(try bridge.setConfiguration(config)) { error in
+            guard case let .preprocessingFailed(_, code) = error as? AbacusError else {
+                return XCTFail("Expected invalid input, got \(error)")
+            }
+            XCTAssertEqual(code, Int(ABVisionErrorInvalidInput.rawValue))
+        }
+
+        // 一部の項目だけが反映されることはない
+        XCTAssertEqual(bridge.configuration?.cellOutputSize, 224)
+        XCTAssertEqual(bridge.configuration?.tensorChannels, 3)
+    }
+
+    // MARK: - Adaptive Threshold Tests
+
+    func testIntegralThresholdMatchesOpenCVMean() throws {
+        try XCTSkipUnless(VisionBridge().isValid, "OpenCV が利用できない環境")
+
+        // 乱数画像で端の複製・平均の丸め・C の切り上げまで一致することを確認
+        let width = 97, height = 61
+        var state: UInt32 = 12345
+        let gray: [UInt8] = (0..<(width * height)).map { _ in
+            state = state &* 1_664_525 &+ 1_013_904_223
+            return UInt8(truncatingIfNeeded: state >> 24)
+        }
+
+        for (blockSize, c) in [(3, 0.0), (11, 2.0), (11, 2.5), (15, -1.5), (31, 7.3)] {
+            let expected = threshold(gray, width, height, ABAdaptiveThresholdMean, blockSize, c)
+            let actual = threshold(gray, width, height, ABAdaptiveThresholdIntegral, blockSize, c)
+            XCTAssertEqual(actual, expected, "blockSize \(blockSize), C \(c)")
+        }
+    }
+
+    func testIntegralThresholdLargeWindowDoesNotOverflow() throws {
+        try XCTSkipUnless(VisionBridge().isValid, "OpenCV が利用できない環境")
+
+        // 窓の面積 × 画素値が int を超え、端を延長した総和も 2^31 を超える大きさ
+        let width = 1200, height = 1100
+        var state: UInt32 = 777
+        let gray: [UInt8] = (0..<(width * height)).map { _ in
+            state = state &* 1_664_525 &+ 1_013_904_223
+            return UInt8(truncatingIfNeeded: state >> 24)
+        }
+
+        let expected = threshold(gray, width, height, ABAdaptiveThresholdMean, 2049, 2.0)
+        let actual = threshold(gray, width, height, ABAdaptiveThresholdIntegral, 2049, 2.0)
+        XCTAssertEqual(actual, expected)
+    }
+
     // MARK: - VisionExtractionResult Tests
 
     func testVisionExtractionResultProperties() {
@@ -48,7 +217,7 @@ final class VisionBridgeTests: XCTestCase {
             ],
             laneCount: 5,
             laneBoundingBoxes: [],
-            tensorData: [],
+            tensor: nil,
             cellCount: 25,
             detectionTimeMs: 15.5
         )
@@ -69,7 +238,7 @@ final class VisionBridgeTests: XCTestCase {
             frameCorners: [],
             laneCount: 0,
             laneBoundingBoxes: [],
-            tensorData: [],
+            tensor: nil,
             cellCount: 0,
             detectionTimeMs: 0
         )
@@ -79,4 +248,103 @@ final class VisionBridgeTests: XCTestCase {
             let _ = result
         }
     }
+
+    // MARK: - VisionTensor Tests
+
+    func testVisionTensorViewsCallerMemoryWithoutCopy() {
+        // 呼び出し側のバッファをそのまま参照し、配列を作らないことを確認
+        var storage: [Float] = (0..<(2 * 3 * 4 * 4)).map { Float($0) }
+
+        storage.withUnsafeMutableBufferPointer { buffer in
+            let tensor = VisionTensor(
+                data: UnsafeRawPointer(buffer.baseAddress!),
+                elementType: .float32,
+                layout: .nchw,
+                batchSize: 2,
+                channels: 3,
+                height: 4,
+                width: 4
+            )
+
+            XCTAssertEqual(tensor.count, buffer.count)
+            XCTAssertEqual(tensor.data, UnsafeRawPointer(buffer.baseAddress!))
+
+            // 書き換えがそのまま見える（コピーではない）
+            buffer[5] = -1
+            let values = tensor.withUnsafeFloats { Array($0) }
+            XCTAssertEqual(values?[5], -1)
+            XCTAssertEqual(values?.last, 95)
+        }
+    }
+
+    func testVisionTensorFloatAccessRequiresFloat32() {
+        var storage = [UInt8](repeating: 0, count: 3 * 8 * 8)
+
+        storage.withUnsafeMutableBytes { bytes in
+            let tensor = VisionTensor(
+                data: UnsafeRawPointer(bytes.baseAddress!),
+                elementType: .uint8,
+                layout: .nhwc,
+                batchSize: 1,
+                channels: 3,
+                height: 8,
+                width: 8
+            )
+            XCTAssertNil(tensor.withUnsafeFloats { $0.count })
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeBuffer(
+        _ data: UnsafeMutableRawPointer?,
+        _ width: Int,
+        _ height: Int,
+        _ bytesPerRow: Int,
+        _ format: ABPixelFormat
+    ) -> ABImageBuffer {
+        var buffer = ABImageBuffer()
+        buffer.data = UnsafeRawPointer(data)
+        buffer.width = Int32(width)
+        buffer.height = Int32(height)
+        buffer.bytesPerRow = bytesPerRow
+        buffer.format = format
+        return buffer
+    }
+
+    private func threshold(
+        _ gray: [UInt8],
+        _ width: Int,
+        _ height: Int,
+        _ method: ABAdaptiveThresholdMethod,
+        _ blockSize: Int,
+        _ c: Double
+    ) -> [UInt8] {
+        var output = [UInt8](repeating: 0, count: width * height)
+        let error = output.withUnsafeMutableBufferPointer { dst in
+            ab_test_adaptive_threshold(
+                gray, Int32(width), Int32(height), 0,
+                method, Int32(blockSize), c,
+                dst.baseAddress, 0
+            )
+        }
+        XCTAssertEqual(error, Int32(ABVisionErrorNone.rawValue))
+        return output
+    }
+
+    private func processError(_ bridge: VisionBridge, _ buffer: ABImageBuffer) -> AbacusError? {
+        do {
+            _ = try bridge.process(buffer: buffer)
+            return nil
+        } catch {
+            return error as? AbacusError
+        }
+    }
+
+    private func isFrameNotDetected(_ error: AbacusError?) -> Bool {
+        if case .frameNotDetected = error {
+            return true
+        }
+        return false
+    }
 }
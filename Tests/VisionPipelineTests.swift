@@ -0,0 +1,161 @@
+// AbacusKit - VisionPipelineTests
+// Swift 6.2
+
+import AbacusVisionBridge
+import CoreGraphics
+import XCTest
+@testable import AbacusKit
+
+/// 合成画像を C++ パイプライン全体に通して、フレーム間の状態と抽出経路を検証するテスト
+final class VisionPipelineTests: XCTestCase {
+    /// 合成画像上のフレーム（両端を含む画素範囲）
+    private struct FrameBox {
+        let x0: Int
+        let y0: Int
+        let x1: Int
+        let y1: Int
+
+        var corners: [CGPoint] {
+            [
+                CGPoint(x: x0, y: y0), CGPoint(x: x1, y: y0),
+                CGPoint(x: x1, y: y1), CGPoint(x: x0, y: y1),
+            ]
+        }
+    }
+
+    // MARK: - Frame Tracking Tests
+
+    func testTrackingFallsBackToDetectionWhenFrameMoves() throws {
+        let bridge = VisionBridge()
+        try XCTSkipUnless(bridge.isValid, "OpenCV が利用できない環境")
+
+        let width = 640, height = 480
+        let first = FrameBox(x0: 80, y0: 160, x1: 560, y1: 320)
+        let moved = FrameBox(x0: 20, y0: 300, x1: 500, y1: 460)
+
+        let detected = try process(bridge, sorobanImage(width, height, first), width, height)
+        assertCorners(detected.frameCorners, first.corners, accuracy: 1.5)
+
+        // 動かないフレームは前回の 4 隅の追跡で見つかる
+        let tracked = try process(bridge, sorobanImage(width, height, first), width, height)
+        assertCorners(tracked.frameCorners, first.corners, accuracy: 2)
+
+        // 前回の 4 隅では辺上のエッジ支持が得られないので、全体検出に戻って移動先を見つける
+        let redetected = try process(bridge, sorobanImage(width, height, moved), width, height)
+        assertCorners(redetected.frameCorners, moved.corners, accuracy: 1.5)
+    }
+
+    // MARK: - Direct Cell Warp Tests
+
+    func testDirectCellWarpMatchesWarpedFrameCells() throws {
+        let warped = VisionBridge()
+        let direct = VisionBridge()
+        try XCTSkipUnless(warped.isValid, "OpenCV が利用できない環境")
+
+        // 8 ビットのまま比較する
+        for bridge in [warped, direct] {
+            var config = try XCTUnwrap(bridge.configuration)
+            config.tensorDataType = ABTensorDataTypeUInt8
+            config.enableDirectCellWarp = bridge === direct
+            try bridge.setConfiguration(config)
+        }
+
+        // 検出レベル (480 × 360) より大きい入力で、直接サンプリングが元解像度を読むようにする
+        let width = 960, height = 720
+        let gray = sorobanImage(width, height, FrameBox(x0: 120, y0: 240, x1: 840, y1: 480), gradient: 60)
+        let bgra = gray.flatMap { [$0, $0, $0, 255] }
+
+        let expected = try process(warped, bgra, width, height, format: ABPixelFormatBGRA)
+        let actual = try process(direct, bgra, width, height, format: ABPixelFormatBGRA)
+
+        // レーン解析の解像度が違っても、同じレーン・セルに分割される
+        XCTAssertEqual(actual.laneCount, expected.laneCount)
+        XCTAssertEqual(actual.laneBoundingBoxes, expected.laneBoundingBoxes)
+        XCTAssertEqual(actual.cellCount, expected.cellCount)
+
+        let actualTensor = try XCTUnwrap(actual.tensor)
+        let expectedTensor = try XCTUnwrap(expected.tensor)
+        XCTAssertEqual(expectedTensor.elementType, .uint8)
+        XCTAssertEqual(actualTensor.count, expectedTensor.count)
+
+        // 補間の回数が違うので珠棒の縁では値が変わるが、セルの位置がずれれば平均の差が大きくなる
+        let actualBytes = UnsafeRawBufferPointer(start: actualTensor.data, count: actualTensor.count)
+        let expectedBytes = UnsafeRawBufferPointer(start: expectedTensor.data, count: expectedTensor.count)
+        let totalDifference = zip(actualBytes, expectedBytes).reduce(0) { $0 + abs(Int($1.0) - Int($1.1)) }
+        XCTAssertLessThan(Double(totalDifference) / Double(max(expectedBytes.count, 1)), 1.5)
+    }
+
+    // MARK: - Helpers
+
+    /// そろばんを模したグレースケール画像
+    /// 暗い背景に明るいフレームと暗い珠棒を置く。背景はフレームの中心を通る暗い線で 4 つに分ける
+    /// （背景が 1 つの領域のままだと、二値化後のフレームが外側の領域に囲まれて外輪郭にならない）。
+    /// - Parameter gradient: フレーム内で左から右へ足す明るさ
+    private func sorobanImage(
+        _ width: Int,
+        _ height: Int,
+        _ frame: FrameBox,
+        rods: Int = 6,
+        gradient: Double = 0
+    ) -> [UInt8] {
+        var pixels = [UInt8](repeating: 60, count: width * height)
+        let centerX = (frame.x0 + frame.x1) / 2
+        let centerY = (frame.y0 + frame.y1) / 2
+        for y in 0..<height {
+            for x in 0..<width where abs(x - centerX) <= 2 || abs(y - centerY) <= 2 {
+                pixels[y * width + x] = 10
+            }
+        }
+
+        let frameWidth = Double(frame.x1 - frame.x0)
+        for y in frame.y0...frame.y1 {
+            for x in frame.x0...frame.x1 {
+                pixels[y * width + x] = UInt8((190 + gradient * Double(x - frame.x0) / frameWidth).rounded())
+            }
+        }
+
+        // 珠棒（幅 12px、フレームの上下 1/8 を空けて横方向の領域をつなげておく）
+        let margin = (frame.y1 - frame.y0) / 8
+        for i in 0..<rods {
+            let center = frame.x0 + (2 * i + 1) * (frame.x1 - frame.x0) / (2 * rods)
+            for y in (frame.y0 + margin)...(frame.y1 - margin) {
+                for x in (center - 6)..<(center + 6) {
+                    pixels[y * width + x] = 90
+                }
+            }
+        }
+        return pixels
+    }
+
+    private func process(
+        _ bridge: VisionBridge,
+        _ pixels: [UInt8],
+        _ width: Int,
+        _ height: Int,
+        format: ABPixelFormat = ABPixelFormatGray
+    ) throws -> VisionExtractionResult {
+        try pixels.withUnsafeBytes { bytes in
+            var buffer = ABImageBuffer()
+            buffer.data = bytes.baseAddress
+            buffer.width = Int32(width)
+            buffer.height = Int32(height)
+            buffer.bytesPerRow = pixels.count / height
+            buffer.format = format
+            return try bridge.process(buffer: buffer)
+        }
+    }
+
+    private func assertCorners(
+        _ actual: [CGPoint],
+        _ expected: [CGPoint],
+        accuracy: CGFloat,
+        file: StaticString = #filePath,
+        line: UInt = #line
+    ) {
+        XCTAssertEqual(actual.count, expected.count, file: file, line: line)
+        for (a, e) in zip(actual, expected) {
+            XCTAssertEqual(a.x, e.x, accuracy: accuracy, file: file, line: line)
+            XCTAssertEqual(a.y, e.y, accuracy: accuracy, file: file, line: line)
+        }
+    }
+}